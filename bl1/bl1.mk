@@ -25,4 +25,9 @@ ifeq (${TRUSTED_BOARD_BOOT},1)
 BL1_SOURCES		+=	bl1/bl1_fwu.c
 endif
 
+ifeq (${ENABLE_BOOT_INSTRUMENTATION},1)
+BL1_SOURCES		+=	lib/pmf/boot_instr.c			\
+				lib/pmf/pmf_main.c
+endif
+
 BL1_LINKERFILE		:=	bl1/bl1.ld.S
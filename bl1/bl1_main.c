@@ -15,6 +15,7 @@
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/console.h>
+#include <lib/boot_instr.h>
 #include <lib/cpus/errata_report.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
@@ -56,6 +57,8 @@ void bl1_calc_bl2_mem_layout(const meminfo_t *bl1_mem_layout,
  ******************************************************************************/
 void bl1_setup(void)
 {
+	boot_instr_mark(BOOT_INSTR_BL1_ENTRY);
+
 	/* Perform early platform-specific setup */
 	bl1_early_platform_setup();
 
@@ -146,6 +149,8 @@ void bl1_main(void)
 
 	bl1_prepare_next_image(image_id);
 
+	boot_instr_print_summary();
+
 	console_flush();
 }
 
@@ -15,6 +15,11 @@ ifeq (${ARCH},aarch64)
 BL2_SOURCES		+=	common/aarch64/early_exceptions.S
 endif
 
+ifeq (${ENABLE_BOOT_INSTRUMENTATION},1)
+BL2_SOURCES		+=	lib/pmf/boot_instr.c			\
+				lib/pmf/pmf_main.c
+endif
+
 ifeq (${BL2_AT_EL3},0)
 BL2_SOURCES		+=	bl2/${ARCH}/bl2_entrypoint.S
 BL2_LINKERFILE		:=	bl2/bl2.ld.S
@@ -11,6 +11,7 @@
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/console.h>
+#include <lib/boot_instr.h>
 #include <plat/common/platform.h>
 
 #include "bl2_private.h"
@@ -28,6 +29,8 @@
 void bl2_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
 	       u_register_t arg3)
 {
+	boot_instr_mark(BOOT_INSTR_BL2_ENTRY);
+
 	/* Perform early platform-specific setup */
 	bl2_early_platform_setup2(arg0, arg1, arg2, arg3);
 
@@ -52,6 +55,8 @@ void bl2_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
 void bl2_el3_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
 		   u_register_t arg3)
 {
+	boot_instr_mark(BOOT_INSTR_BL2_ENTRY);
+
 	/* Perform early platform-specific setup */
 	bl2_el3_early_platform_setup(arg0, arg1, arg2, arg3);
 
@@ -96,6 +101,11 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if TRUSTED_BOARD_BOOT
+	/* Wipe the authentication state before leaving BL2 */
+	auth_mod_exit();
+#endif /* TRUSTED_BOARD_BOOT */
+
 #if !BL2_AT_EL3
 #ifdef AARCH32
 	/*
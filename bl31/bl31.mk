@@ -43,6 +43,14 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_BOOT_INSTRUMENTATION},1)
+BL31_SOURCES		+=	lib/pmf/boot_instr.c
+endif
+
+ifeq (${ENABLE_EL3_TRACE},1)
+BL31_SOURCES		+=	lib/pmf/el3_trace.c
+endif
+
 ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
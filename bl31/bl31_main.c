@@ -15,7 +15,9 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <drivers/console.h>
+#include <lib/boot_instr.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -61,6 +63,7 @@ uintptr_t get_arm_std_svc_args(unsigned int svc_mask)
 void __init bl31_lib_init(void)
 {
 	cm_init();
+	el3_trace_init();
 }
 
 /*******************************************************************************
@@ -69,6 +72,8 @@ void __init bl31_lib_init(void)
 void bl31_setup(u_register_t arg0, u_register_t arg1, u_register_t arg2,
 		u_register_t arg3)
 {
+	boot_instr_mark(BOOT_INSTR_BL31_ENTRY);
+
 	/* Perform early platform-specific setup */
 	bl31_early_platform_setup2(arg0, arg1, arg2, arg3);
 
@@ -142,6 +147,9 @@ void bl31_main(void)
 	 */
 	bl31_prepare_next_image_entry();
 
+	boot_instr_mark(BOOT_INSTR_BL31_EXIT);
+	boot_instr_print_summary();
+
 	console_flush();
 
 	/*
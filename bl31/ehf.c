@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,6 +16,7 @@
 #include <context.h>
 #include <common/debug.h>
 #include <drivers/arm/gic_common.h>
+#include <lib/el3_trace.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
@@ -440,12 +441,16 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 		panic();
 	}
 
+	el3_trace_event(EL3_TRACE_INTR_ENTRY, intr, pri);
+
 	/*
 	 * Call registered handler. Pass the raw interrupt value to registered
 	 * handlers.
 	 */
 	ret = handler(intr_raw, flags, handle, cookie);
 
+	el3_trace_event(EL3_TRACE_INTR_EXIT, intr, (u_register_t)ret);
+
 	return (uint64_t) ret;
 }
 
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <arch.h>
@@ -15,10 +16,22 @@
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/io/io_storage.h>
+#include <lib/boot_instr.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <plat/common/platform.h>
 
+/*
+ * Size of the chunks an image is read in when it is hashed while loading. Each
+ * chunk is hashed right after it is read, while it is still in the cache.
+ */
+#ifndef LOAD_IMAGE_HASH_CHUNK_SIZE
+#define LOAD_IMAGE_HASH_CHUNK_SIZE	U(0x8000)
+#endif
+
+/* Consumer of the next image loaded by load_auth_image(), if any */
+static const image_load_stream_t *image_load_stream;
+
 #if TRUSTED_BOARD_BOOT
 # ifdef DYN_DISABLE_AUTH
 static int disable_auth;
@@ -63,24 +76,52 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
- * If the load is successful then the image information is updated.
+ * If the load is successful then the image information is updated. If
+ * 'hash_on_load' is set, the image is passed to the authentication module in
+ * chunks as it is read, so that its hash is ready once it has been loaded.
+ * If the device can read in the background, each chunk is then read while
+ * the previous one is hashed.
+ * If 'stream' is not NULL, the image is read into its buffer one chunk at a
+ * time and handed to it rather than loaded at image_base. Once the stream has
+ * been started, it is aborted if the load fails.
+ *
+ * With LOAD_IMAGE_ZERO_COPY, an image stored in a memory-mapped device is not
+ * copied when it can be used in place: certificates are always parsed where
+ * they are, other images only if they are already at their image_base.
+ * 'in_place_addr' is set to the address of the image data if it is used in
+ * place, or to 0 if it has been loaded.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      int is_parent_image, int hash_on_load,
+		      const image_load_stream_t *stream, uintptr_t *in_place_addr)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
 	uintptr_t image_spec;
 	uintptr_t image_base;
 	size_t image_size;
+	size_t max_size;
+	size_t chunk_size;
+	size_t offset;
 	size_t bytes_read;
 	int io_result;
+	int in_place = 0;
+	int pipeline = 0;
+	int pending = 0;
+	int streaming = 0;
+	unsigned long long start;
+	unsigned long long overlap_start = 0ULL;
 
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_2);
+	assert(in_place_addr != NULL);
+
+	*in_place_addr = 0U;
 
 	image_base = image_data->image_base;
+	start = boot_instr_now();
 
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
@@ -108,31 +149,143 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 		goto exit;
 	}
 
-	/* Check that the image size to load is within limit */
-	if (image_size > image_data->image_max_size) {
+#if LOAD_IMAGE_ZERO_COPY
+	if (stream == NULL) {
+		uintptr_t map_base;
+
+		if ((io_map(image_handle, image_size, &map_base) == 0) &&
+		    (map_base != 0U) &&
+		    ((is_parent_image != 0) || (map_base == image_base))) {
+			image_base = map_base;
+			in_place = 1;
+		}
+	}
+#endif /* LOAD_IMAGE_ZERO_COPY */
+
+	/*
+	 * Check that the image size to load is within limit. A certificate used
+	 * in place is not stored at image_base. A streamed image is not either,
+	 * but its consumer writes its output there, so its data isn't accepted
+	 * if it is larger than the image may be.
+	 */
+	if ((in_place != 0) && (is_parent_image != 0)) {
+		max_size = UINT32_MAX;
+	} else {
+		max_size = image_data->image_max_size;
+	}
+	if (image_size > max_size) {
 		WARN("Image id=%u size out of bounds\n", image_id);
 		io_result = -EFBIG;
 		goto exit;
 	}
 
-	/*
-	 * image_data->image_max_size is a uint32_t so image_size will always
-	 * fit in image_data->image_size.
-	 */
+	/* max_size fits in a uint32_t so image_size also does */
 	image_data->image_size = (uint32_t)image_size;
 
+	boot_instr_image_add(BOOT_INSTR_IMAGE_OPEN, start);
+
+	if (stream != NULL) {
+		io_result = stream->start(image_size);
+		if (io_result != 0) {
+			WARN("Failed to start streaming image id=%u (%i)\n",
+			     image_id, io_result);
+			goto exit;
+		}
+		streaming = 1;
+		chunk_size = stream->buf_size;
+	} else if ((hash_on_load != 0) && (in_place == 0)) {
+		chunk_size = LOAD_IMAGE_HASH_CHUNK_SIZE;
+		pipeline = 1;
+	} else {
+		chunk_size = image_size;
+	}
+
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
-	if ((io_result != 0) || (bytes_read < image_size)) {
-		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
-		goto exit;
+	for (offset = 0U; offset < image_size; offset += chunk_size) {
+		uintptr_t chunk_base = (stream != NULL) ? stream->buf_base :
+							  image_base + offset;
+
+		chunk_size = MIN(chunk_size, image_size - offset);
+
+		/* An image used in place is already in memory */
+		if (in_place == 0) {
+			start = boot_instr_now();
+			if (pending != 0) {
+				/* Read while the last chunk was hashed */
+				boot_instr_image_add(BOOT_INSTR_IMAGE_OVERLAP,
+						     overlap_start);
+				pending = 0;
+				io_result = io_read_wait(image_handle,
+							 &bytes_read);
+			} else {
+				io_result = io_read(image_handle, chunk_base,
+						    chunk_size, &bytes_read);
+			}
+			if ((io_result == 0) && (bytes_read == chunk_size) &&
+			    (pipeline != 0) &&
+			    (chunk_size < (image_size - offset))) {
+				/* Start reading the next chunk */
+				io_result = io_read_start(image_handle,
+					chunk_base + chunk_size,
+					MIN(chunk_size,
+					    image_size - offset - chunk_size));
+				if (io_result == 0) {
+					pending = 1;
+					overlap_start = boot_instr_now();
+				} else if (io_result == -ENOTSUP) {
+					pipeline = 0;
+					io_result = 0;
+				}
+			}
+			boot_instr_image_add(BOOT_INSTR_IMAGE_READ, start);
+			if ((io_result == 0) && (bytes_read < chunk_size)) {
+				io_result = -EIO;
+			}
+			if (io_result != 0) {
+				WARN("Failed to load image id=%u (%i)\n",
+				     image_id, io_result);
+				goto exit;
+			}
+		}
+
+#if TRUSTED_BOARD_BOOT
+		if (hash_on_load != 0) {
+			start = boot_instr_now();
+			auth_mod_hash_update((void *)chunk_base,
+					     (unsigned int)chunk_size);
+			boot_instr_image_add(BOOT_INSTR_IMAGE_AUTH, start);
+		}
+#endif /* TRUSTED_BOARD_BOOT */
+
+		if (stream != NULL) {
+			io_result = stream->write(chunk_base, chunk_size);
+			if (io_result != 0) {
+				WARN("Failed to stream image id=%u (%i)\n",
+				     image_id, io_result);
+				goto exit;
+			}
+		}
 	}
 
-	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
+	INFO("Image id=%u %s: 0x%lx - 0x%lx\n", image_id,
+	     (in_place != 0) ? "used in place" : "loaded", image_base,
 	     (uintptr_t)(image_base + image_size));
+	if (in_place != 0) {
+		*in_place_addr = image_base;
+	}
 
 exit:
+	/* Don't let a device write to the image after it has been rejected */
+	if (pending != 0) {
+		(void)io_read_wait(image_handle, &bytes_read);
+	}
+
+	/* Wipe what the consumer has written of a streamed image */
+	if ((io_result != 0) && (streaming != 0)) {
+		stream->abort();
+	}
+
 	(void)io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
@@ -148,6 +301,11 @@ static int load_auth_image_internal(unsigned int image_id,
 				    int is_parent_image)
 {
 	int rc;
+	int hash_on_load = 0;
+	uintptr_t in_place_addr;
+	/* Parent images are certificates, which are always loaded in place */
+	const image_load_stream_t *stream =
+		(is_parent_image == 0) ? image_load_stream : NULL;
 
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
@@ -161,27 +319,46 @@ static int load_auth_image_internal(unsigned int image_id,
 				return rc;
 			}
 		}
+
+		/* Hash the image while it is loaded, if possible */
+		hash_on_load = (auth_mod_hash_start(image_id) == 0) ? 1 : 0;
+
+		/* A streamed image is not kept, so it must be hashed now */
+		if ((stream != NULL) && (hash_on_load == 0)) {
+			WARN("Image id=%u can't be authenticated if streamed\n",
+			     image_id);
+			return -EAUTH;
+		}
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
-	rc = load_image(image_id, image_data);
+	rc = load_image(image_id, image_data, is_parent_image, hash_on_load,
+			stream, &in_place_addr);
 	if (rc != 0) {
 		return rc;
 	}
 
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
+		unsigned long long start = boot_instr_now();
+		uintptr_t image_addr = (in_place_addr != 0U) ? in_place_addr :
+					image_data->image_base;
+
 		/* Authenticate it */
-		rc = auth_mod_verify_img(image_id,
-					 (void *)image_data->image_base,
+		rc = auth_mod_verify_img(image_id, (void *)image_addr,
 					 image_data->image_size);
+		boot_instr_image_add(BOOT_INSTR_IMAGE_AUTH, start);
 		if (rc != 0) {
 			/* Authentication error, zero memory and flush it right away. */
-			zero_normalmem((void *)image_data->image_base,
-			       image_data->image_size);
-			flush_dcache_range(image_data->image_base,
-					   image_data->image_size);
+			if (stream != NULL) {
+				stream->abort();
+			} else if (in_place_addr == 0U) {
+				zero_normalmem((void *)image_data->image_base,
+				       image_data->image_size);
+				flush_dcache_range(image_data->image_base,
+						   image_data->image_size);
+			}
 			return -EAUTH;
 		}
 	}
@@ -191,9 +368,12 @@ static int load_auth_image_internal(unsigned int image_id,
 	 * Flush the image to main memory so that it can be executed later by
 	 * any CPU, regardless of cache and MMU state. If TBB is enabled, then
 	 * the file has been successfully loaded and authenticated and flush
-	 * only for child images, not for the parents (certificates).
+	 * only for child images, not for the parents (certificates). A streamed
+	 * image is flushed by its consumer and an image used in place has not
+	 * been written.
 	 */
-	if (is_parent_image == 0) {
+	if ((is_parent_image == 0) && (stream == NULL) &&
+	    (in_place_addr == 0U)) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
 	}
@@ -213,6 +393,9 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 {
 	int err;
 
+	/* Account the parent images to this one in the boot-time records */
+	boot_instr_image_begin(image_id);
+
 	do {
 		err = load_auth_image_internal(image_id, image_data, 0);
 	} while ((err != 0) && (plat_try_next_boot_source() != 0));
@@ -220,6 +403,17 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 	return err;
 }
 
+/*******************************************************************************
+ * Set the consumer of the images loaded by load_auth_image() from now on, or
+ * pass NULL to load them at their image_base again.
+ ******************************************************************************/
+void set_image_load_stream(const image_load_stream_t *stream)
+{
+	assert((stream == NULL) || (stream->buf_size != 0U));
+
+	image_load_stream = stream;
+}
+
 /*******************************************************************************
  * Print the content of an entry_point_info_t structure.
  ******************************************************************************/
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,7 @@
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/desc_image_load.h>
+#include <lib/boot_instr.h>
 
 static bl_load_info_t bl_load_info;
 static bl_params_t next_bl_params;
@@ -156,7 +157,9 @@ bl_params_t *get_next_bl_params_from_mem_params_desc(void)
 	assert(next_bl_params.head != NULL);
 
 	/* Populate the HEAD information */
-	SET_PARAM_HEAD(&next_bl_params, PARAM_BL_PARAMS, VERSION_2, 0U);
+	SET_PARAM_HEAD(&next_bl_params, PARAM_BL_PARAMS, VERSION_2,
+		       sizeof(next_bl_params));
+	next_bl_params.boot_instr = boot_instr_export();
 
 	/*
 	 * Go through the image descriptor array and create the list.
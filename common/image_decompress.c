@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,39 +11,153 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <lib/boot_instr.h>
+#include <lib/utils.h>
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
+static const decompressor_stream_t *stream_decompressor;
 static struct image_info saved_image_info;
 
+static int image_decompress_stream_start(size_t image_size);
+static int image_decompress_stream_write(uintptr_t buf, size_t len);
+static void image_decompress_stream_abort(void);
+
+/*
+ * In streaming mode, the temporary buffer holds the chunk being decompressed
+ * followed by the workspace of the decompressor.
+ */
+static image_load_stream_t image_load_stream = {
+	.buf_size = IMAGE_DECOMPRESS_STREAM_CHUNK_SIZE,
+	.start = image_decompress_stream_start,
+	.write = image_decompress_stream_write,
+	.abort = image_decompress_stream_abort,
+};
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
 	decompressor_buf_base = buf_base;
 	decompressor_buf_size = buf_size;
 	decompressor = _decompressor;
+	stream_decompressor = NULL;
+}
+
+/*
+ * Decompress images while they are loaded. The temporary buffer only needs
+ * to hold one chunk of compressed data and the workspace of the decompressor,
+ * instead of the whole compressed image.
+ *
+ * The decompressor then runs on data that has not been authenticated yet. Its
+ * output is bounded by the image_max_size of the image, and it is wiped if the
+ * load or the authentication fails.
+ */
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  const decompressor_stream_t *_decompressor)
+{
+	assert(buf_size > IMAGE_DECOMPRESS_STREAM_CHUNK_SIZE);
+
+	decompressor_buf_base = buf_base;
+	decompressor_buf_size = buf_size;
+	decompressor = NULL;
+	stream_decompressor = _decompressor;
+	image_load_stream.buf_base = buf_base;
+}
+
+static int image_decompress_stream_start(size_t image_size)
+{
+	uintptr_t work_base = decompressor_buf_base +
+			      IMAGE_DECOMPRESS_STREAM_CHUNK_SIZE;
+	uint32_t work_size = decompressor_buf_size -
+			     IMAGE_DECOMPRESS_STREAM_CHUNK_SIZE;
+
+	return stream_decompressor->start(saved_image_info.image_base,
+					  saved_image_info.image_max_size,
+					  work_base, work_size);
+}
+
+static int image_decompress_stream_write(uintptr_t buf, size_t len)
+{
+	unsigned long long start = boot_instr_now();
+	int ret;
+
+	ret = stream_decompressor->update(buf, len);
+	boot_instr_image_add(BOOT_INSTR_IMAGE_DECOMPRESS, start);
+
+	return ret;
+}
+
+/* Wipe the output of an image that failed to load or authenticate */
+static void image_decompress_stream_abort(void)
+{
+	uintptr_t image_base;
+
+	(void)stream_decompressor->finish(&image_base);
+
+	zero_normalmem((void *)saved_image_info.image_base,
+		       image_base - saved_image_info.image_base);
+	flush_dcache_range(saved_image_info.image_base,
+			   image_base - saved_image_info.image_base);
 }
 
 void image_decompress_prepare(struct image_info *info)
 {
+	saved_image_info = *info;
+
+	/*
+	 * In streaming mode, load_image() hands the compressed data to the
+	 * decompressor as it is read, which writes its output to the final
+	 * destination of the image.
+	 */
+	if (stream_decompressor != NULL) {
+		set_image_load_stream(&image_load_stream);
+		return;
+	}
+
 	/*
 	 * If the image is compressed, it should be loaded into the temporary
 	 * buffer instead of its final destination.  We save image_info, then
 	 * override ->image_base and ->image_max_size so that load_image() will
 	 * transfer the compressed data to the temporary buffer.
 	 */
-	saved_image_info = *info;
 	info->image_base = decompressor_buf_base;
 	info->image_max_size = decompressor_buf_size;
 }
 
+static int image_decompress_stream_end(struct image_info *info)
+{
+	uintptr_t image_base;
+	unsigned long long start;
+	int ret;
+
+	set_image_load_stream(NULL);
+
+	start = boot_instr_now();
+	ret = stream_decompressor->finish(&image_base);
+	boot_instr_image_add(BOOT_INSTR_IMAGE_DECOMPRESS, start);
+	if (ret) {
+		ERROR("Failed to decompress image (err=%d)\n", ret);
+		return ret;
+	}
+
+	info->image_size = image_base - info->image_base;
+
+	flush_dcache_range(info->image_base, info->image_size);
+
+	return 0;
+}
+
 int image_decompress(struct image_info *info)
 {
 	uintptr_t compressed_image_base, image_base, work_base;
 	uint32_t compressed_image_size, work_size;
+	unsigned long long start;
 	int ret;
 
+	if (stream_decompressor != NULL)
+		return image_decompress_stream_end(info);
+
 	/*
 	 * The size of compressed data has been filled by load_image().
 	 * Read it out before restoring image_info.
@@ -63,9 +177,11 @@ int image_decompress(struct image_info *info)
 	work_base = compressed_image_base + compressed_image_size;
 	work_size = decompressor_buf_size - compressed_image_size;
 
+	start = boot_instr_now();
 	ret = decompressor(&compressed_image_base, compressed_image_size,
 			   &image_base, info->image_max_size,
 			   work_base, work_size);
+	boot_instr_image_add(BOOT_INSTR_IMAGE_DECOMPRESS, start);
 	if (ret) {
 		ERROR("Failed to decompress image (err=%d)\n", ret);
 		return ret;
@@ -10,12 +10,14 @@
 
 #include <platform_def.h>
 
+#include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/tbbr/cot_def.h>
 #include <drivers/auth/auth_common.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/img_parser_mod.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
 /* ASN.1 tags */
@@ -32,8 +34,16 @@
 
 /* Pointer to CoT */
 extern const auth_img_desc_t *const *const cot_desc_ptr;
+extern const unsigned int cot_desc_size;
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
+/*
+ * Image whose hash is being calculated while it is loaded, or
+ * INVALID_IMAGE_ID, and the number of bytes hashed so far.
+ */
+static unsigned int hash_stream_img_id = INVALID_IMAGE_ID;
+static unsigned int hash_stream_len;
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -112,6 +122,13 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			img, img_len, &data_ptr, &data_len);
 	return_if_error(rc);
 
+	/* The hash is already calculated if the data was hashed while loaded */
+	if ((hash_stream_img_id == img_desc->img_id) && (data_ptr == img) &&
+	    (data_len == hash_stream_len)) {
+		hash_stream_img_id = INVALID_IMAGE_ID;
+		return crypto_mod_hash_finish();
+	}
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -294,6 +311,142 @@ int plat_set_nv_ctr2(void *cookie, const auth_img_desc_t *img_desc __unused,
 	return plat_set_nv_ctr(cookie, nv_ctr);
 }
 
+/*
+ * Return 1 if any authentication parameter of 'a' is stored in the same
+ * buffer as one of 'b', 0 otherwise.
+ */
+static int auth_shares_param_buf(const auth_img_desc_t *a,
+				 const auth_img_desc_t *b)
+{
+	int i, j;
+
+	if ((a->authenticated_data == NULL) || (b->authenticated_data == NULL))
+		return 0;
+
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (a->authenticated_data[i].type_desc == NULL)
+			continue;
+		for (j = 0 ; j < COT_MAX_VERIFIED_PARAMS ; j++) {
+			if ((b->authenticated_data[j].type_desc != NULL) &&
+			    (a->authenticated_data[i].data.ptr ==
+			     b->authenticated_data[j].data.ptr)) {
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * The parameters extracted from an authenticated image stay in their buffers
+ * so that the image does not need to be loaded and verified again while its
+ * children are authenticated. Platforms may reuse a buffer for images that
+ * are never needed at the same time (e.g. 'content_pk_buf' in the TBBR CoT).
+ * Before the buffers of 'img_desc' are overwritten, forget every image that
+ * has its parameters in one of them, so that it is verified again if needed.
+ */
+static void auth_invalidate_param_bufs(const auth_img_desc_t *img_desc)
+{
+	const auth_img_desc_t *other;
+	unsigned int i;
+
+	for (i = 0U ; i < cot_desc_size ; i++) {
+		other = cot_desc_ptr[i];
+		if ((other == NULL) ||
+		    ((auth_img_flags[i] & IMG_FLAG_AUTHENTICATED) == 0U))
+			continue;
+		if (auth_shares_param_buf(img_desc, other) != 0)
+			auth_img_flags[i] &= ~IMG_FLAG_AUTHENTICATED;
+	}
+}
+
+/*
+ * Discard the hash started by auth_mod_hash_start(), if any
+ */
+static void auth_hash_stream_abort(void)
+{
+	if (hash_stream_img_id != INVALID_IMAGE_ID) {
+		(void)crypto_mod_hash_finish();
+		hash_stream_img_id = INVALID_IMAGE_ID;
+	}
+}
+
+/*
+ * Prepare to hash an image while it is loaded
+ *
+ * This is possible for a raw image that is authenticated only by its hash,
+ * once its parent has been authenticated. The image must then be passed to
+ * auth_mod_hash_update() in order, as it is loaded, and to
+ * auth_mod_verify_img() once loaded.
+ *
+ * Return value:
+ *   0 = Hashing started, 1 = The image must be verified after loading
+ */
+int auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *hash_method = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int i;
+
+	auth_hash_stream_abort();
+
+	if (img_id >= cot_desc_size)
+		return 1;
+
+	img_desc = cot_desc_ptr[img_id];
+	if ((img_desc == NULL) || (img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL) || (img_desc->parent == NULL))
+		return 1;
+
+	if ((auth_img_flags[img_desc->parent->img_id] &
+	     IMG_FLAG_AUTHENTICATED) == 0U)
+		return 1;
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		switch (img_desc->img_auth_methods[i].type) {
+		case AUTH_METHOD_NONE:
+			break;
+		case AUTH_METHOD_HASH:
+			if (hash_method != NULL)
+				return 1;
+			hash_method = &img_desc->img_auth_methods[i];
+			break;
+		default:
+			return 1;
+		}
+	}
+
+	if (hash_method == NULL)
+		return 1;
+
+	if (auth_get_param(hash_method->param.hash.hash, img_desc->parent,
+			   &hash_der_ptr, &hash_der_len) != 0)
+		return 1;
+
+	if (crypto_mod_hash_start(hash_der_ptr, hash_der_len) != CRYPTO_SUCCESS)
+		return 1;
+
+	hash_stream_img_id = img_id;
+	hash_stream_len = 0U;
+
+	return 0;
+}
+
+/*
+ * Add the next chunk of the image being loaded to its hash. A failure is
+ * reported when the image is verified.
+ */
+void auth_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(hash_stream_img_id != INVALID_IMAGE_ID);
+
+	(void)crypto_mod_hash_update(data_ptr, data_len);
+	hash_stream_len += data_len;
+}
+
 /*
  * Return the parent id in the output parameter '*parent_id'
  *
@@ -340,14 +493,41 @@ void auth_mod_init(void)
 	img_parser_init();
 }
 
+/*
+ * Forget all the authenticated images and wipe the parameters extracted from
+ * them. This must be called before handing over to the next boot stage.
+ */
+void auth_mod_exit(void)
+{
+	const auth_img_desc_t *img_desc;
+	unsigned int i;
+	int j;
+
+	auth_hash_stream_abort();
+	zeromem(auth_img_flags, sizeof(auth_img_flags));
+
+	for (i = 0U ; i < cot_desc_size ; i++) {
+		img_desc = cot_desc_ptr[i];
+		if ((img_desc == NULL) || (img_desc->authenticated_data == NULL))
+			continue;
+
+		for (j = 0 ; j < COT_MAX_VERIFIED_PARAMS ; j++) {
+			if (img_desc->authenticated_data[j].type_desc == NULL)
+				continue;
+			zeromem(img_desc->authenticated_data[j].data.ptr,
+				img_desc->authenticated_data[j].data.len);
+		}
+	}
+}
+
 /*
  * Authenticate a certificate/image
  *
  * Return: 0 = success, Otherwise = error
  */
-int auth_mod_verify_img(unsigned int img_id,
-			void *img_ptr,
-			unsigned int img_len)
+static int auth_verify_img(unsigned int img_id,
+			   void *img_ptr,
+			   unsigned int img_len)
 {
 	const auth_img_desc_t *img_desc = NULL;
 	const auth_method_desc_t *auth_method = NULL;
@@ -395,6 +575,8 @@ int auth_mod_verify_img(unsigned int img_id,
 	/* Extract the parameters indicated in the image descriptor to
 	 * authenticate the children images. */
 	if (img_desc->authenticated_data != NULL) {
+		auth_invalidate_param_bufs(img_desc);
+
 		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
 			if (img_desc->authenticated_data[i].type_desc == NULL) {
 				continue;
@@ -422,3 +604,17 @@ int auth_mod_verify_img(unsigned int img_id,
 
 	return 0;
 }
+
+int auth_mod_verify_img(unsigned int img_id,
+			void *img_ptr,
+			unsigned int img_len)
+{
+	int rc;
+
+	rc = auth_verify_img(img_id, img_ptr, img_len);
+
+	/* Release the hash context if the image failed before it was used */
+	auth_hash_stream_abort();
+
+	return rc;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -48,6 +48,12 @@ void crypto_mod_init(void)
 	assert(crypto_lib_desc.init != NULL);
 	assert(crypto_lib_desc.verify_signature != NULL);
 	assert(crypto_lib_desc.verify_hash != NULL);
+	assert(((crypto_lib_desc.hash_start == NULL) &&
+		(crypto_lib_desc.hash_update == NULL) &&
+		(crypto_lib_desc.hash_finish == NULL)) ||
+	       ((crypto_lib_desc.hash_start != NULL) &&
+		(crypto_lib_desc.hash_update != NULL) &&
+		(crypto_lib_desc.hash_finish != NULL)));
 
 	/* Initialize the cryptographic library */
 	crypto_lib_desc.init();
@@ -103,3 +109,51 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start verifying a hash incrementally, so that the data can be hashed as it
+ * is loaded. Returns CRYPTO_ERR_UNKNOWN if the library does not support it,
+ * in which case the caller should use crypto_mod_verify_hash() instead.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if (crypto_lib_desc.hash_start == NULL) {
+		return CRYPTO_ERR_UNKNOWN;
+	}
+
+	return crypto_lib_desc.hash_start(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add data to the hash started by crypto_mod_hash_start()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: next chunk of data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(crypto_lib_desc.hash_update != NULL);
+
+	return crypto_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete the hash started by crypto_mod_hash_start() and compare it with the
+ * expected one. This must be called once for every successful
+ * crypto_mod_hash_start(), even if the result is not needed.
+ */
+int crypto_mod_hash_finish(void)
+{
+	assert(crypto_lib_desc.hash_finish != NULL);
+
+	return crypto_lib_desc.hash_finish();
+}
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -77,9 +77,26 @@ else
     $(error "TF_MBEDTLS_KEY_ALG=${TF_MBEDTLS_KEY_ALG} not supported on mbed TLS")
 endif
 
+# The platform may set 'TF_MBEDTLS_USE_SHA256_CE' to 1 to compute SHA-256 with
+# the ARMv8 Cryptographic Extension instructions instead of the C code in
+# mbed TLS.
+ifeq (${TF_MBEDTLS_USE_SHA256_CE},)
+    TF_MBEDTLS_USE_SHA256_CE	:=	0
+endif
+
+ifeq (${TF_MBEDTLS_USE_SHA256_CE},1)
+    ifneq (${ARCH},aarch64)
+        $(error "TF_MBEDTLS_USE_SHA256_CE=1 is only supported on AArch64")
+    endif
+    MBEDTLS_SOURCES	+=	drivers/auth/mbedtls/mbedtls_sha256_ce.c	\
+				drivers/auth/mbedtls/aarch64/sha256_ce.S
+endif
+
 # Needs to be set to drive mbed TLS configuration correctly
+$(eval $(call assert_boolean,TF_MBEDTLS_USE_SHA256_CE))
 $(eval $(call add_define,TF_MBEDTLS_KEY_ALG_ID))
 $(eval $(call add_define,TF_MBEDTLS_HASH_ALG_ID))
+$(eval $(call add_define,TF_MBEDTLS_USE_SHA256_CE))
 
 
 $(eval $(call MAKE_LIB,mbedtls))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,6 +17,9 @@
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <drivers/auth/mbedtls/mbedtls_config.h>
+#if TF_MBEDTLS_USE_SHA256_CE
+#include <drivers/auth/mbedtls/mbedtls_sha256_ce.h>
+#endif
 
 #define LIB_NAME		"mbed TLS"
 
@@ -44,6 +47,10 @@ static void init(void)
 {
 	/* Initialize mbed TLS */
 	mbedtls_init();
+
+#if TF_MBEDTLS_USE_SHA256_CE
+	mbedtls_sha256_ce_init();
+#endif
 }
 
 /*
@@ -136,19 +143,18 @@ end2:
 }
 
 /*
- * Match a hash
+ * Get the hash algorithm and the expected hash from a DigestInfo
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -172,8 +178,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -184,10 +190,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -205,7 +233,76 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * Incremental hash state. The expected hash is copied because the buffer it
+ * comes from may be reused before the hash is complete. 'hash_err' records a
+ * failed update so that it is reported by hash_finish().
+ */
+static mbedtls_md_context_t hash_ctx;
+static unsigned char hash_expected[MBEDTLS_MD_MAX_SIZE];
+static int hash_err;
+
+/*
+ * Start an incremental hash of the algorithm given in the DigestInfo
+ */
+static int hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	mbedtls_md_init(&hash_ctx);
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&hash_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	memcpy(hash_expected, hash, mbedtls_md_get_size(md_info));
+	hash_err = 0;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	if ((hash_err == 0) &&
+	    (mbedtls_md_update(&hash_ctx, data_ptr, data_len) != 0)) {
+		hash_err = 1;
+	}
+
+	return (hash_err == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_HASH;
+}
+
+static int hash_finish(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc = CRYPTO_ERR_HASH;
+
+	if ((hash_err == 0) && (mbedtls_md_finish(&hash_ctx, data_hash) == 0) &&
+	    (memcmp(data_hash, hash_expected,
+		    mbedtls_md_get_size(hash_ctx.md_info)) == 0)) {
+		rc = CRYPTO_SUCCESS;
+	}
+
+	mbedtls_md_free(&hash_ctx);
+
+	return rc;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_HASH_STREAM(LIB_NAME, init, verify_signature, verify_hash,
+				hash_start, hash_update, hash_finish);
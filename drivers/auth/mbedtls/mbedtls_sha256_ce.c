@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/auth/mbedtls/mbedtls_config.h>
+#include <drivers/auth/mbedtls/mbedtls_sha256_ce.h>
+#include <lib/utils_def.h>
+
+/*
+ * SHA-256 known-answer tests from FIPS 180-2. The second message is padded
+ * to two blocks, so the chaining of the state is also covered.
+ */
+static const struct {
+	const char *msg;
+	unsigned char digest[32];
+} sha256_ce_kat[] = {
+	{
+		"abc",
+		{
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+		0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+		0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+		}
+	},
+	{
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		{
+		0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+		0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+		0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+		0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+		}
+	},
+};
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/* Set by mbedtls_sha256_ce_init() if the CPU has the SHA-256 instructions */
+static bool sha256_ce_present;
+
+#define ROR32(x, n)	(((x) >> (n)) | ((x) << (32U - (n))))
+
+/*
+ * Portable block function, used on CPUs without the SHA-256 instructions.
+ * MBEDTLS_SHA256_PROCESS_ALT leaves it out of mbed TLS, so it is here too.
+ */
+static void sha256_c_process(uint32_t state[8], const unsigned char data[64])
+{
+	uint32_t w[64];
+	uint32_t a[8];
+	uint32_t s0, s1, t1, t2;
+	unsigned int i;
+
+	for (i = 0U; i < 16U; i++) {
+		w[i] = ((uint32_t)data[4U * i] << 24) |
+		       ((uint32_t)data[(4U * i) + 1U] << 16) |
+		       ((uint32_t)data[(4U * i) + 2U] << 8) |
+		       (uint32_t)data[(4U * i) + 3U];
+	}
+
+	for (i = 16U; i < 64U; i++) {
+		s0 = ROR32(w[i - 15U], 7U) ^ ROR32(w[i - 15U], 18U) ^
+		     (w[i - 15U] >> 3);
+		s1 = ROR32(w[i - 2U], 17U) ^ ROR32(w[i - 2U], 19U) ^
+		     (w[i - 2U] >> 10);
+		w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+	}
+
+	(void)memcpy(a, state, sizeof(a));
+
+	for (i = 0U; i < 64U; i++) {
+		t1 = a[7] + (ROR32(a[4], 6U) ^ ROR32(a[4], 11U) ^
+			     ROR32(a[4], 25U)) +
+		     ((a[4] & a[5]) ^ (~a[4] & a[6])) + sha256_k[i] + w[i];
+		t2 = (ROR32(a[0], 2U) ^ ROR32(a[0], 13U) ^ ROR32(a[0], 22U)) +
+		     ((a[0] & a[1]) ^ (a[0] & a[2]) ^ (a[1] & a[2]));
+		a[7] = a[6];
+		a[6] = a[5];
+		a[5] = a[4];
+		a[4] = a[3] + t1;
+		a[3] = a[2];
+		a[2] = a[1];
+		a[1] = a[0];
+		a[0] = t1 + t2;
+	}
+
+	for (i = 0U; i < 8U; i++) {
+		state[i] += a[i];
+	}
+}
+
+/*
+ * Block function used by the mbed TLS SHA-256 module when
+ * MBEDTLS_SHA256_PROCESS_ALT is defined. Everything else (buffering,
+ * padding, the message digest layer) is still done by mbed TLS.
+ */
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
+				    const unsigned char data[64])
+{
+	if (sha256_ce_present) {
+		sha256_ce_process(ctx->state, data, 1U);
+	} else {
+		sha256_c_process(ctx->state, data);
+	}
+
+	return 0;
+}
+
+/*
+ * Use the SHA-256 instructions if the CPU implements them, or the C block
+ * function otherwise, and check that it gives the expected results through
+ * the mbed TLS API.
+ */
+void mbedtls_sha256_ce_init(void)
+{
+	unsigned char digest[32];
+	unsigned int i;
+	int rc;
+
+	sha256_ce_present = ((read_id_aa64isar0_el1() >>
+			      ID_AA64ISAR0_SHA2_SHIFT) &
+			     ID_AA64ISAR0_SHA2_MASK) != 0U;
+	if (!sha256_ce_present) {
+		WARN("SHA-256 instructions not implemented, using C code\n");
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(sha256_ce_kat); i++) {
+		rc = mbedtls_sha256_ret(
+			(const unsigned char *)sha256_ce_kat[i].msg,
+			strlen(sha256_ce_kat[i].msg), digest, 0);
+		if ((rc != 0) || (memcmp(digest, sha256_ce_kat[i].digest,
+					 sizeof(digest)) != 0)) {
+			ERROR("SHA-256 known-answer test %u failed\n", i);
+			panic();
+		}
+	}
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <drivers/buffered_console.h>
+#include <lib/cassert.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+CASSERT(CONSOLE_LOG_RING_T_MAGIC == __builtin_offsetof(console_log_ring_t,
+	magic), assert_console_log_ring_t_magic_offset_mismatch);
+CASSERT(CONSOLE_LOG_RING_T_SIZE == __builtin_offsetof(console_log_ring_t,
+	size), assert_console_log_ring_t_size_offset_mismatch);
+CASSERT(CONSOLE_LOG_RING_T_HEAD == __builtin_offsetof(console_log_ring_t,
+	head), assert_console_log_ring_t_head_offset_mismatch);
+CASSERT(CONSOLE_LOG_RING_T_TAIL == __builtin_offsetof(console_log_ring_t,
+	tail), assert_console_log_ring_t_tail_offset_mismatch);
+CASSERT(CONSOLE_LOG_RING_T_DATA == sizeof(console_log_ring_t),
+	assert_console_log_ring_t_data_offset_mismatch);
+
+static int console_buffered_putc(int c, console_t *console);
+static int console_buffered_getc(console_t *console);
+static int console_buffered_flush(console_t *console);
+
+static console_t buffered_console = {
+	.putc = console_buffered_putc,
+	.getc = console_buffered_getc,
+	.flush = console_buffered_flush,
+};
+
+static console_t *backend_console;
+static console_tx_burst_t backend_tx_burst;
+static uintptr_t log_rings;
+static unsigned int log_ring_size;
+
+/* Held by the CPU that is sending characters to the backend */
+static spinlock_t drain_lock;
+
+/*
+ * Head and tail of each ring. The log region may be writable by the normal
+ * world, so the head and tail in the ring headers are only a copy for readers
+ * of the log: they are written but never read back.
+ */
+static struct {
+	volatile uint64_t head;
+	volatile uint64_t tail;
+} ring_pos[PLATFORM_CORE_COUNT];
+
+static console_log_ring_t *get_ring(unsigned int core_pos)
+{
+	return (console_log_ring_t *)(log_rings + (core_pos *
+			CONSOLE_LOG_RING_STRIDE(log_ring_size)));
+}
+
+/*
+ * Send the rings in CPU order until the backend has no room left. Each ring
+ * has a single producer, its CPU, and a single consumer, the CPU holding
+ * drain_lock. The producer only advances head and the consumer only advances
+ * tail, so the rings themselves need no lock. A ring is only sent up to the
+ * head read when starting on it, at most log_ring_size characters.
+ */
+static void drain_rings(void)
+{
+	console_log_ring_t *ring;
+	uint64_t head, tail;
+	unsigned int i, offset, len;
+	int sent;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		ring = get_ring(i);
+		head = ring_pos[i].head;
+		tail = ring_pos[i].tail;
+
+		/* Read the characters only after head */
+		dmbish();
+
+		while (tail != head) {
+			offset = (unsigned int)tail & (log_ring_size - 1U);
+			len = (unsigned int)MIN(head - tail,
+					(uint64_t)(log_ring_size - offset));
+			sent = backend_tx_burst(backend_console,
+						&ring->data[offset], len);
+			if (sent <= 0) {
+				return;
+			}
+
+			/* Release the characters only after reading them */
+			dmbish();
+			tail += MIN((uint64_t)sent, (uint64_t)len);
+			ring_pos[i].tail = tail;
+			ring->tail = tail;
+		}
+	}
+}
+
+void console_buffered_drain(void)
+{
+	/* If another CPU is already draining, it sends our characters too */
+	if (spin_trylock(&drain_lock) == 0) {
+		return;
+	}
+
+	drain_rings();
+
+	spin_unlock(&drain_lock);
+}
+
+static int console_buffered_putc(int c, console_t *console)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	console_log_ring_t *ring = get_ring(core_pos);
+	uint64_t head = ring_pos[core_pos].head;
+
+	/* Wait for room rather than lose characters */
+	while ((head - ring_pos[core_pos].tail) >= log_ring_size) {
+		console_buffered_drain();
+	}
+
+	ring->data[(unsigned int)head & (log_ring_size - 1U)] = (uint8_t)c;
+
+	/* Publish the character before the new head */
+	dmbish();
+	ring_pos[core_pos].head = head + 1U;
+	ring->head = head + 1U;
+
+	console_buffered_drain();
+
+	return c;
+}
+
+static int console_buffered_getc(console_t *console)
+{
+	console_buffered_drain();
+
+	if (backend_console->getc == NULL) {
+		return ERROR_NO_PENDING_CHAR;
+	}
+
+	return backend_console->getc(backend_console);
+}
+
+/*
+ * Send what is in the rings when called, waiting for the UART as needed.
+ * Characters printed meanwhile by other CPUs are left to them.
+ */
+static int console_buffered_flush(console_t *console)
+{
+	uint64_t head[PLATFORM_CORE_COUNT];
+	unsigned int i;
+	bool pending;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		head[i] = ring_pos[i].head;
+	}
+
+	do {
+		console_buffered_drain();
+
+		pending = false;
+		for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+			if ((int64_t)(head[i] - ring_pos[i].tail) > 0) {
+				pending = true;
+			}
+		}
+	} while (pending);
+
+	if (backend_console->flush == NULL) {
+		return 0;
+	}
+
+	return backend_console->flush(backend_console);
+}
+
+int console_buffered_register(console_t *backend, console_tx_burst_t tx_burst,
+			      uintptr_t log_base, unsigned int ring_size)
+{
+	console_log_ring_t *ring;
+	unsigned int i;
+
+	if ((backend == NULL) || (tx_burst == NULL) || (log_base == 0U) ||
+	    (ring_size == 0U) || ((ring_size & (ring_size - 1U)) != 0U)) {
+		return 0;
+	}
+
+	assert(console_is_registered(backend) == 1);
+	assert(console_is_registered(&buffered_console) == 0);
+
+	backend_console = backend;
+	backend_tx_burst = tx_burst;
+	log_rings = log_base;
+	log_ring_size = ring_size;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		ring = get_ring(i);
+		ring->magic = CONSOLE_LOG_RING_MAGIC;
+		ring->size = ring_size;
+		ring->head = 0U;
+		ring->tail = 0U;
+		ring_pos[i].head = 0U;
+		ring_pos[i].tail = 0U;
+	}
+
+	/* Characters of the boot and runtime scopes now go through the rings */
+	buffered_console.flags = backend->flags &
+				 (CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME);
+	console_set_scope(backend,
+			  (unsigned int)backend->flags & CONSOLE_FLAG_CRASH);
+
+	return console_register(&buffered_console);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,11 +16,21 @@
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
 
+/* Whole blocks being read in the background, and the tail to read after them */
+typedef struct {
+	int			lba;
+	uintptr_t		buffer;
+	size_t			size;
+	size_t			tail;
+	size_t			length;
+} block_pending_read_t;
+
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+	block_pending_read_t	pending;
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -30,8 +40,12 @@ io_type_t device_type_block(void);
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		      io_entity_t *entity);
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
+static int block_len(io_entity_t *entity, size_t *length);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length);
+static int block_read_wait(io_entity_t *entity, size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
@@ -46,8 +60,10 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.type		= device_type_block,
 	.open		= block_open,
 	.seek		= block_seek,
-	.size		= NULL,
+	.size		= block_len,
 	.read		= block_read,
+	.read_start	= block_read_start,
+	.read_wait	= block_read_wait,
 	.write		= block_write,
 	.close		= block_close,
 	.dev_init	= NULL,
@@ -171,6 +187,15 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+static int block_len(io_entity_t *entity, size_t *length)
+{
+	assert((entity->info != (uintptr_t)NULL) && (length != NULL));
+
+	*length = ((block_dev_state_t *)entity->info)->size;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,6 +265,12 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * If the device has the IO_BLOCK_DIRECT_READ flag, the bounce buffer is only
+ * needed for the partial blocks. When the caller's buffer has the same
+ * alignment in a block as the position on the device, the whole blocks in the
+ * middle of the request are read straight into it with a single call to
+ * ops->read(), and only the head and tail blocks go through the bounce buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -264,6 +295,9 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	 */
 	size_t padding;
 
+	/* whether whole blocks can be read into the caller's buffer */
+	int direct;
+
 	assert(entity->info != (uintptr_t)NULL);
 	cur = (block_dev_state_t *)entity->info;
 	ops = &(cur->dev_spec->ops);
@@ -273,6 +307,14 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0) &&
 	       (ops->read != 0));
 
+	/*
+	 * Once the head block is done, the caller's buffer is block-aligned
+	 * only if it is aligned like the position on the device in a block.
+	 */
+	direct = ((cur->dev_spec->flags & IO_BLOCK_DIRECT_READ) != 0U) &&
+		 (((buffer - (cur->file_pos + cur->base)) &
+		   (block_size - 1)) == 0U);
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to read in every iteration, because it will depend
@@ -296,7 +338,26 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
-		if (skip + left > buf->length) {
+		if (direct && (skip == 0) && (left >= block_size)) {
+			/* Read all the whole blocks in one go */
+			request = left & ~(block_size - 1);
+			nbytes = ops->read(lba, buffer + count, request);
+			if ((nbytes == 0) || (nbytes > request)) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
+		if (direct) {
+			/*
+			 * Only the head or tail block is needed, the rest
+			 * is read directly.
+			 */
+			request = block_size;
+		} else if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
 			 * read all the required data - limit to just
@@ -346,6 +407,102 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Start reading the whole blocks of a request straight into the caller's
+ * buffer, if the device can read in the background. The partial head block
+ * is read now and the partial tail block by block_read_wait(), both through
+ * the bounce buffer. -ENOTSUP is returned if there isn't any whole block to
+ * read directly, and the caller should then use block_read().
+ */
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	block_pending_read_t *pending;
+	size_t block_size, head, size, nbytes;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	pending = &(cur->pending);
+	block_size = cur->dev_spec->block_size;
+	assert((length <= cur->size) &&
+	       (length > 0) &&
+	       (pending->size == 0U));
+
+	if ((ops->read_start == NULL) || (ops->read_wait == NULL) ||
+	    ((cur->dev_spec->flags & IO_BLOCK_DIRECT_READ) == 0U) ||
+	    (((buffer - (cur->file_pos + cur->base)) &
+	      (block_size - 1)) != 0U)) {
+		return -ENOTSUP;
+	}
+
+	head = (block_size - (cur->file_pos & (block_size - 1))) &
+	       (block_size - 1);
+	if (head >= length) {
+		return -ENOTSUP;
+	}
+
+	size = (length - head) & ~(block_size - 1);
+	if (size == 0U) {
+		return -ENOTSUP;
+	}
+
+	if (head != 0U) {
+		result = block_read(entity, buffer, head, &nbytes);
+		if (result != 0) {
+			return result;
+		}
+	}
+
+	pending->lba = (cur->file_pos + cur->base) / block_size;
+	pending->buffer = buffer + head;
+	pending->tail = length - head - size;
+	pending->length = length;
+	if (ops->read_start(pending->lba, pending->buffer, size) != 0) {
+		return -EIO;
+	}
+	pending->size = size;
+
+	return 0;
+}
+
+/* Wait for the read started by block_read_start() and read the tail block */
+static int block_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	block_pending_read_t *pending;
+	size_t nbytes;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	pending = &(cur->pending);
+	assert(pending->size != 0U);
+
+	nbytes = ops->read_wait(pending->lba, pending->buffer, pending->size);
+	if (nbytes != pending->size) {
+		pending->size = 0U;
+		return -EIO;
+	}
+	pending->size = 0U;
+	cur->file_pos += nbytes;
+
+	if (pending->tail != 0U) {
+		if (block_read(entity, pending->buffer + nbytes, pending->tail,
+			       &nbytes) != 0) {
+			return -EIO;
+		}
+	}
+
+	*length_read = pending->length;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
@@ -25,6 +25,16 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/* Number of Table of Contents entries cached per FIP device */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	32
+#endif
+
+/* Number of files that can be open at the same time across all FIP devices */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		MAX_IO_HANDLES
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -35,30 +45,44 @@
 
 typedef struct {
 	unsigned int file_pos;
-	fip_toc_entry_t entry;
+	const fip_toc_entry_t *entry;
+	/* Backend held open by a read started with fip_file_read_start() */
+	uintptr_t pending_handle;
 } file_state_t;
 
 /*
- * Maintain dev_spec per FIP Device
- * TODO - Add backend handles and file state
- * per FIP device here once backends like io_memmap
- * can support multiple open files
+ * Table of Contents as laid out at the start of the package. One extra entry
+ * is reserved for the null UUID that terminates the list.
+ */
+typedef struct {
+	fip_toc_header_t header;
+	fip_toc_entry_t entries[MAX_FIP_TOC_ENTRIES + 1];
+} fip_toc_t;
+
+/*
+ * Maintain dev_spec, backend and a cached copy of the Table of Contents per
+ * FIP Device. The TOC is read once by fip_dev_init() and its entries are kept
+ * sorted by UUID so that files can be looked up without accessing the
+ * backend. 'toc_image_id' is the image id the cache was built from, or
+ * INVALID_IMAGE_ID when there is no valid cache.
  */
 typedef struct {
 	uintptr_t dev_spec;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
+	unsigned int toc_image_id;
+	unsigned int toc_num_entries;
+	fip_toc_t toc;
 } fip_dev_state_t;
 
 static const uuid_t uuid_null;
+
 /*
- * Only one file can be open across all FIP device
- * as backends like io_memmap don't support
- * multiple open files. The file state and
- * backend handle should be maintained per FIP device
- * if the same support is available in the backend
+ * Backends like io_memmap don't support multiple open files, so the backend
+ * is only held open for the duration of a read. That lets several files,
+ * possibly from different FIP devices, be open at the same time.
  */
-static file_state_t current_file = {0};
-static uintptr_t backend_dev_handle;
-static uintptr_t backend_image_spec;
+static file_state_t file_pool[MAX_FIP_FILES];
 
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
@@ -73,6 +97,10 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_map(io_entity_t *entity, size_t length, uintptr_t *addr);
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length);
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -95,6 +123,51 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+/*
+ * Sort the cached TOC entries by UUID. There are only a few dozen entries at
+ * most, so an insertion sort is good enough.
+ */
+static void sort_toc_entries(fip_toc_entry_t *entries, unsigned int num)
+{
+	unsigned int i, j;
+	fip_toc_entry_t tmp;
+
+	for (i = 1U; i < num; i++) {
+		tmp = entries[i];
+		for (j = i; j > 0U; j--) {
+			if (compare_uuids(&entries[j - 1U].uuid, &tmp.uuid) <= 0)
+				break;
+			entries[j] = entries[j - 1U];
+		}
+		entries[j] = tmp;
+	}
+}
+
+
+/* Binary search the cached TOC of a FIP device for a UUID */
+static const fip_toc_entry_t *find_toc_entry(const fip_dev_state_t *state,
+					     const uuid_t *uuid)
+{
+	unsigned int lo = 0U;
+	unsigned int hi = state->toc_num_entries;
+	unsigned int mid;
+	int cmp;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		cmp = compare_uuids(&state->toc.entries[mid].uuid, uuid);
+		if (cmp == 0)
+			return &state->toc.entries[mid];
+		if (cmp < 0)
+			lo = mid + 1U;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
+
 /* Identify the device type as a virtual driver */
 static io_type_t device_type_fip(void)
 {
@@ -113,6 +186,9 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.seek = NULL,
 	.size = fip_file_len,
 	.read = fip_file_read,
+	.map = fip_file_map,
+	.read_start = fip_file_read_start,
+	.read_wait = fip_file_read_wait,
 	.write = NULL,
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
@@ -183,8 +259,8 @@ static int free_dev_info(io_dev_info_t *dev_info)
 
 /*
  * Multiple FIP devices can be opened depending on the value of
- * MAX_FIP_DEVICES. Given that there is only one backend, only a
- * single file can be open at a time by any FIP device.
+ * MAX_FIP_DEVICES. Up to MAX_FIP_FILES files can be open at a time
+ * across all FIP devices.
  */
 static int fip_dev_open(const uintptr_t dev_spec,
 			 io_dev_info_t **dev_info)
@@ -205,6 +281,7 @@ static int fip_dev_open(const uintptr_t dev_spec,
 	state = (fip_dev_state_t *)info->info;
 
 	state->dev_spec = dev_spec;
+	state->toc_image_id = INVALID_IMAGE_ID;
 
 	*dev_info = info;
 
@@ -212,18 +289,35 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
-/* Do some basic package checks. */
+/*
+ * Do some basic package checks and cache the Table of Contents. Platforms
+ * call this before every access to the package, so the TOC is only read from
+ * the backend the first time and kept until the device is closed.
+ */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
 	uintptr_t backend_handle;
-	fip_toc_header_t header;
+	fip_dev_state_t *state;
+	size_t toc_size;
+	size_t backend_size;
 	size_t bytes_read;
+	unsigned int num;
+	unsigned int max_num;
+
+	assert(dev_info != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
+	if (state->toc_image_id == image_id) {
+		return 0;
+	}
+	state->toc_image_id = INVALID_IMAGE_ID;
+	state->toc_num_entries = 0U;
 
 	/* Obtain a reference to the image by querying the platform layer */
-	result = plat_get_image_source(image_id, &backend_dev_handle,
-				       &backend_image_spec);
+	result = plat_get_image_source(image_id, &state->backend_dev_handle,
+				       &state->backend_image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
 			image_id, result);
@@ -232,7 +326,7 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	}
 
 	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
 			 &backend_handle);
 	if (result != 0) {
 		WARN("Failed to access image id=%u (%i)\n", image_id, result);
@@ -240,17 +334,55 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
-	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
-			&bytes_read);
-	if (result == 0) {
-		if (!is_valid_header(&header)) {
-			WARN("Firmware Image Package header check failed.\n");
-			result = -ENOENT;
-		} else {
-			VERBOSE("FIP header looks OK.\n");
-		}
+	/*
+	 * Read the header and as many TOC entries as the cache holds in one
+	 * go, without reading past the end of the backend image.
+	 */
+	toc_size = sizeof(state->toc);
+	if ((io_size(backend_handle, &backend_size) == 0) &&
+	    (backend_size < toc_size)) {
+		toc_size = backend_size;
+	}
+
+	result = io_read(backend_handle, (uintptr_t)&state->toc, toc_size,
+			 &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read FIP (%i)\n", result);
+		result = -ENOENT;
+		goto fip_dev_init_close;
+	}
+
+	if ((bytes_read < sizeof(fip_toc_header_t)) ||
+	    !is_valid_header(&state->toc.header)) {
+		WARN("Firmware Image Package header check failed.\n");
+		result = -ENOENT;
+		goto fip_dev_init_close;
+	}
+	VERBOSE("FIP header looks OK.\n");
+
+	max_num = (unsigned int)((bytes_read - sizeof(fip_toc_header_t)) /
+				 sizeof(fip_toc_entry_t));
+	for (num = 0U; num < max_num; num++) {
+		if (compare_uuids(&state->toc.entries[num].uuid,
+				  &uuid_null) == 0)
+			break;
 	}
 
+	if (num == max_num) {
+		if (max_num > MAX_FIP_TOC_ENTRIES)
+			WARN("FIP has more than %u TOC entries\n",
+			     MAX_FIP_TOC_ENTRIES);
+		else
+			WARN("FIP Table of Contents is truncated\n");
+		result = -ENOENT;
+		goto fip_dev_init_close;
+	}
+
+	sort_toc_entries(state->toc.entries, num);
+	state->toc_num_entries = num;
+	state->toc_image_id = image_id;
+
+ fip_dev_init_close:
 	io_close(backend_handle);
 
  fip_dev_init_exit:
@@ -262,10 +394,7 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 {
 	/* TODO: Consider tracking open files and cleaning them up here */
 
-	/* Clear the backend. */
-	backend_dev_handle = (uintptr_t)NULL;
-	backend_image_spec = (uintptr_t)NULL;
-
+	/* The backend and the cached TOC are cleared with the state. */
 	return free_dev_info(dev_info);
 }
 
@@ -274,79 +403,44 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
-	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_dev_state_t *state;
+	const fip_toc_entry_t *entry;
+	unsigned int index;
 
+	assert(dev_info != NULL);
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return -ENOMEM;
+	state = (fip_dev_state_t *)dev_info->info;
+	if (state->toc_image_id == INVALID_IMAGE_ID) {
+		WARN("fip_file_open: FIP device is not initialised\n");
+		return -ENOENT;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+	entry = find_toc_entry(state, &uuid_spec->uuid);
+	if (entry == NULL) {
+		/* Did not find the file in the FIP. */
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
-	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
+	/* An active file always has an entry, so a NULL one marks a free slot */
+	for (index = 0U; index < (unsigned int)MAX_FIP_FILES; index++) {
+		if (file_pool[index].entry == NULL)
+			break;
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-				break;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
-		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
-		result = -ENOENT;
+	if (index == (unsigned int)MAX_FIP_FILES) {
+		WARN("fip_file_open : Too many open files.\n");
+		return -ENOMEM;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	/* The entry holds the base and size of the file. */
+	file_pool[index].entry = entry;
+	file_pool[index].file_pos = 0;
+	entity->info = (uintptr_t)&file_pool[index];
 
- fip_file_open_exit:
-	return result;
+	return 0;
 }
 
 
@@ -356,7 +450,7 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	*length =  ((file_state_t *)entity->info)->entry.size;
+	*length =  ((file_state_t *)entity->info)->entry->size;
 
 	return 0;
 }
@@ -368,6 +462,7 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 {
 	int result;
 	file_state_t *fp;
+	const fip_dev_state_t *state;
 	size_t file_offset;
 	size_t bytes_read;
 	uintptr_t backend_handle;
@@ -375,9 +470,12 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(entity != NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
+	assert(entity->dev_handle != NULL);
+
+	state = (fip_dev_state_t *)entity->dev_handle->info;
 
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
 			 &backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
@@ -388,7 +486,7 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	fp = (file_state_t *)entity->info;
 
 	/* Seek to the position in the FIP where the payload lives */
-	file_offset = fp->entry.offset_address + fp->file_pos;
+	file_offset = fp->entry->offset_address + fp->file_pos;
 	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
 	if (result != 0) {
 		WARN("fip_file_read: failed to seek\n");
@@ -417,14 +515,145 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/* Return the address of data in a file in package, if the backend is mapped */
+static int fip_file_map(io_entity_t *entity, size_t length, uintptr_t *addr)
+{
+	int result;
+	const file_state_t *fp;
+	const fip_dev_state_t *state;
+	size_t file_offset;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(addr != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+	assert(entity->dev_handle != NULL);
+
+	state = (fip_dev_state_t *)entity->dev_handle->info;
+	fp = (file_state_t *)entity->info;
+
+	if ((length > fp->entry->size) ||
+	    (fp->file_pos > (fp->entry->size - length))) {
+		return -EINVAL;
+	}
+
+	/* Open the backend, attempt to access the blob image */
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry->offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+	if (result != 0) {
+		WARN("fip_file_map: failed to seek\n");
+		result = -ENOENT;
+	} else {
+		/* Most backends aren't memory-mapped, so don't warn here */
+		result = io_map(backend_handle, length, addr);
+	}
+
+	io_close(backend_handle);
+
+	return result;
+}
+
+
+/*
+ * Start reading a file in package, if the backend can read in the background.
+ * The backend is then held open until fip_file_read_wait().
+ */
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length)
+{
+	int result;
+	file_state_t *fp;
+	const fip_dev_state_t *state;
+	size_t file_offset;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+	assert(entity->dev_handle != NULL);
+
+	state = (fip_dev_state_t *)entity->dev_handle->info;
+	fp = (file_state_t *)entity->info;
+	assert(fp->pending_handle == (uintptr_t)NULL);
+
+	/* Open the backend, attempt to access the blob image */
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry->offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+	if (result != 0) {
+		WARN("fip_file_read_start: failed to seek\n");
+		result = -ENOENT;
+	} else {
+		/* Most backends can't read in the background, so don't warn */
+		result = io_read_start(backend_handle, buffer, length);
+	}
+
+	if (result != 0) {
+		io_close(backend_handle);
+		return result;
+	}
+
+	fp->pending_handle = backend_handle;
+
+	return 0;
+}
+
+
+/* Wait for the read started by fip_file_read_start() and close the backend */
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t bytes_read;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+	assert(fp->pending_handle != (uintptr_t)NULL);
+
+	result = io_read_wait(fp->pending_handle, &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		result = -ENOENT;
+	} else {
+		*length_read = bytes_read;
+		fp->file_pos += bytes_read;
+	}
+
+	io_close(fp->pending_handle);
+	fp->pending_handle = (uintptr_t)NULL;
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		zeromem(&current_file, sizeof(current_file));
+	file_state_t *fp;
+
+	assert(entity != NULL);
+
+	/* Return the file state to the pool. */
+	fp = (file_state_t *)entity->info;
+	if (fp != NULL) {
+		zeromem(fp, sizeof(*fp));
 	}
 
 	/* Clear the Entity info. */
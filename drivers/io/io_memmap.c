@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -46,6 +46,8 @@ static int memmap_block_seek(io_entity_t *entity, int mode,
 static int memmap_block_len(io_entity_t *entity, size_t *length);
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *addr);
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
@@ -63,6 +65,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.seek = memmap_block_seek,
 	.size = memmap_block_len,
 	.read = memmap_block_read,
+	.map = memmap_block_map,
 	.write = memmap_block_write,
 	.close = memmap_block_close,
 	.dev_init = NULL,
@@ -191,6 +194,27 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 }
 
 
+/* Return the address of data in a file on the memmap device */
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *addr)
+{
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(addr != NULL);
+
+	fp = (file_state_t *) entity->info;
+
+	if ((length > fp->size) || (fp->file_pos > (fp->size - length))) {
+		return -EINVAL;
+	}
+
+	*addr = fp->base + fp->file_pos;
+
+	return 0;
+}
+
+
 /* Write data to a file on the memmap device */
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written)
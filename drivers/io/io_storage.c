@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -290,6 +290,66 @@ int io_read(uintptr_t handle,
 }
 
 
+/*
+ * Get the address at which the next 'length' bytes of an IO entity can be
+ * accessed directly. Only memory-mapped devices support this, -ENOTSUP is
+ * returned otherwise. The position in the entity is not changed.
+ */
+int io_map(uintptr_t handle, size_t length, uintptr_t *addr)
+{
+	int result = -ENOTSUP;
+	assert(is_valid_entity(handle) && (addr != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->map != NULL)
+		result = dev->funcs->map(entity, length, addr);
+
+	return result;
+}
+
+
+/*
+ * Start reading data from an IO entity without waiting for it, so that the
+ * caller can work while the device transfers the data. Only the devices that
+ * read in the background support this, -ENOTSUP is returned otherwise and the
+ * caller should use io_read(). If the read is started, io_read_wait() must be
+ * called before the entity or its device is used again, and the buffer must
+ * not be accessed until then.
+ */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length)
+{
+	int result = -ENOTSUP;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if ((dev->funcs->read_start != NULL) && (dev->funcs->read_wait != NULL))
+		result = dev->funcs->read_start(entity, buffer, length);
+
+	return result;
+}
+
+
+/* Wait for the read started by io_read_start() to complete */
+int io_read_wait(uintptr_t handle, size_t *length_read)
+{
+	assert(is_valid_entity(handle) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	assert(dev->funcs->read_wait != NULL);
+
+	return dev->funcs->read_wait(entity, length_read);
+}
+
+
 /* Write data to an IO entity */
 int io_write(uintptr_t handle,
 		const uintptr_t buffer,
@@ -30,6 +30,16 @@ static unsigned int mmc_flags;
 static struct mmc_device_info *mmc_dev_info;
 static unsigned int rca;
 static unsigned int scr[2]__aligned(16) = { 0 };
+static unsigned long long mmc_read_bytes;
+static unsigned long long mmc_read_ticks;
+static unsigned long long mmc_read_start;
+
+static const char *const mmc_timing_names[] = {
+	[MMC_TIMING_LEGACY] = "legacy",
+	[MMC_TIMING_DDR52] = "DDR52",
+	[MMC_TIMING_HS200] = "HS200",
+	[MMC_TIMING_HS400] = "HS400",
+};
 
 static const unsigned char tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 26, 30, 35, 40, 45, 52, 55, 60, 70, 80
@@ -217,6 +227,36 @@ static int mmc_set_ios(unsigned int clk, unsigned int bus_width)
 	return ops->set_ios(clk, width);
 }
 
+static int mmc_read_ext_csd(void)
+{
+	int ret;
+
+	ret = ops->prepare(0, (uintptr_t)&mmc_ext_csd, sizeof(mmc_ext_csd));
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* MMC CMD8: SEND_EXT_CSD */
+	ret = mmc_send_cmd(MMC_CMD(8), 0, MMC_RESPONSE_R1, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->read(0, (uintptr_t)&mmc_ext_csd, sizeof(mmc_ext_csd));
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_device_state();
+		if (ret < 0) {
+			return ret;
+		}
+	} while (ret != MMC_STATE_TRAN);
+
+	return 0;
+}
+
 static int mmc_fill_device_info(void)
 {
 	unsigned long long c_size;
@@ -230,31 +270,11 @@ static int mmc_fill_device_info(void)
 	case MMC_IS_EMMC:
 		mmc_dev_info->block_size = MMC_BLOCK_SIZE;
 
-		ret = ops->prepare(0, (uintptr_t)&mmc_ext_csd,
-				   sizeof(mmc_ext_csd));
-		if (ret != 0) {
-			return ret;
-		}
-
-		/* MMC CMD8: SEND_EXT_CSD */
-		ret = mmc_send_cmd(MMC_CMD(8), 0, MMC_RESPONSE_R1, NULL);
+		ret = mmc_read_ext_csd();
 		if (ret != 0) {
 			return ret;
 		}
 
-		ret = ops->read(0, (uintptr_t)&mmc_ext_csd,
-				sizeof(mmc_ext_csd));
-		if (ret != 0) {
-			return ret;
-		}
-
-		do {
-			ret = mmc_device_state();
-			if (ret < 0) {
-				return ret;
-			}
-		} while (ret != MMC_STATE_TRAN);
-
 		nb_blocks = (mmc_ext_csd[CMD_EXTCSD_SEC_CNT] << 0) |
 			    (mmc_ext_csd[CMD_EXTCSD_SEC_CNT + 1] << 8) |
 			    (mmc_ext_csd[CMD_EXTCSD_SEC_CNT + 2] << 16) |
@@ -327,6 +347,271 @@ static int mmc_fill_device_info(void)
 	return 0;
 }
 
+/*
+ * Set the I/O voltage for a bus mode, given the DEVICE_TYPE bits of the mode
+ * at 1.8 V and 1.2 V.
+ */
+static int mmc_set_mode_voltage(unsigned int type_1v8, unsigned int type_1v2)
+{
+	unsigned int dev_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+
+	if (ops->set_voltage == NULL) {
+		return ((dev_type & type_1v8) != 0U) ? 0 : -ENOTSUP;
+	}
+
+	if (((dev_type & type_1v8) != 0U) &&
+	    (ops->set_voltage(MMC_SIGNAL_VOLTAGE_180) == 0)) {
+		return 0;
+	}
+
+	if (((dev_type & type_1v2) != 0U) &&
+	    (ops->set_voltage(MMC_SIGNAL_VOLTAGE_120) == 0)) {
+		return 0;
+	}
+
+	return -ENOTSUP;
+}
+
+static int mmc_set_timing(enum mmc_timing timing, unsigned int clk,
+			  unsigned int width)
+{
+	int ret;
+
+	if (ops->set_timing != NULL) {
+		ret = ops->set_timing(timing);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return ops->set_ios(clk, width);
+}
+
+/* Switch the card and the host from legacy timing to HS200 and tune */
+static int mmc_enter_hs200(unsigned int width)
+{
+	int ret;
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS200);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_timing(MMC_TIMING_HS200, MMC_HS200_CLK_RATE, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return ops->execute_tuning();
+}
+
+/*
+ * Switch the card and the host from legacy timing to HS400. The bus is tuned
+ * in HS200, then HS400 is entered through high speed timing at 52 MHz.
+ */
+static int mmc_enter_hs400(void)
+{
+	int ret;
+
+	ret = mmc_enter_hs200(MMC_BUS_WIDTH_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_timing(MMC_TIMING_LEGACY, MMC_HS_CLK_RATE,
+			     MMC_BUS_WIDTH_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, MMC_BUS_WIDTH_DDR_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS400);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_set_timing(MMC_TIMING_HS400, MMC_HS200_CLK_RATE,
+			      MMC_BUS_WIDTH_DDR_8);
+}
+
+/* Switch the card and the host from legacy timing to DDR52 */
+static int mmc_enter_ddr52(unsigned int width)
+{
+	unsigned int ddr_width = (width == MMC_BUS_WIDTH_8) ?
+				 MMC_BUS_WIDTH_DDR_8 : MMC_BUS_WIDTH_DDR_4;
+	int ret;
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, ddr_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_set_timing(MMC_TIMING_DDR52, MMC_HS_CLK_RATE, ddr_width);
+}
+
+/* Go back to the legacy bus mode set up by mmc_enumerate() */
+static int mmc_restore_legacy(unsigned int clk, unsigned int width)
+{
+	int ret;
+
+	/* Lower the clock first, the card accepts commands at any speed */
+	ret = mmc_set_timing(MMC_TIMING_LEGACY, clk, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_BACKWARD);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* EXT_CSD may have been read back wrong in the failed mode */
+	return mmc_read_ext_csd();
+}
+
+/*
+ * Try a bus mode, then check that EXT_CSD can be read back in that mode with
+ * the expected HS_TIMING. On failure, go back to the legacy mode.
+ */
+static int mmc_try_bus_mode(enum mmc_timing timing, unsigned int clk,
+			    unsigned int width)
+{
+	unsigned int dev_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	unsigned int type_1v8, type_1v2, hs_timing;
+	int ret;
+
+	switch (timing) {
+	case MMC_TIMING_HS400:
+		type_1v8 = MMC_DEVICE_TYPE_HS400_1V8;
+		type_1v2 = MMC_DEVICE_TYPE_HS400_1V2;
+		hs_timing = MMC_HS_TIMING_HS400;
+		break;
+	case MMC_TIMING_HS200:
+		type_1v8 = MMC_DEVICE_TYPE_HS200_1V8;
+		type_1v2 = MMC_DEVICE_TYPE_HS200_1V2;
+		hs_timing = MMC_HS_TIMING_HS200;
+		break;
+	case MMC_TIMING_DDR52:
+		type_1v8 = MMC_DEVICE_TYPE_DDR52_1V8;
+		type_1v2 = MMC_DEVICE_TYPE_DDR52_1V2;
+		hs_timing = MMC_HS_TIMING_HS;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	/* Nothing has been changed if the card can't use the mode */
+	if (mmc_set_mode_voltage(type_1v8, type_1v2) != 0) {
+		return -ENOTSUP;
+	}
+
+	if (timing == MMC_TIMING_HS400) {
+		ret = mmc_enter_hs400();
+	} else if (timing == MMC_TIMING_HS200) {
+		ret = mmc_enter_hs200(width);
+	} else {
+		ret = mmc_enter_ddr52(width);
+	}
+
+	if (ret == 0) {
+		ret = mmc_read_ext_csd();
+	}
+
+	if ((ret == 0) &&
+	    ((mmc_ext_csd[CMD_EXTCSD_HS_TIMING] != hs_timing) ||
+	     (mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE] != dev_type))) {
+		ret = -EIO;
+	}
+
+	if (ret != 0) {
+		WARN("MMC: %s mode failed (%d), falling back\n",
+		     mmc_timing_names[timing], ret);
+		if (mmc_restore_legacy(clk, width) != 0) {
+			return -EIO;
+		}
+		/* Keep trying slower modes */
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+/*
+ * Switch an eMMC to the fastest bus mode supported by both the card, as read
+ * from DEVICE_TYPE in EXT_CSD, and the host, as given by the flags passed to
+ * mmc_init(). The legacy mode is kept if none of them works.
+ */
+static int mmc_select_bus_mode(unsigned int clk, unsigned int width)
+{
+	static const struct {
+		enum mmc_timing timing;
+		unsigned int flag;
+	} modes[] = {
+		{ MMC_TIMING_HS400, MMC_FLAG_HS400 },
+		{ MMC_TIMING_HS200, MMC_FLAG_HS200 },
+		{ MMC_TIMING_DDR52, MMC_FLAG_DDR52 },
+	};
+	unsigned int i;
+	int ret;
+
+	mmc_dev_info->timing = MMC_TIMING_LEGACY;
+
+	if ((mmc_dev_info->mmc_dev_type != MMC_IS_EMMC) ||
+	    (mmc_csd.spec_vers != 4U) ||
+	    ((width != MMC_BUS_WIDTH_4) && (width != MMC_BUS_WIDTH_8))) {
+		return 0;
+	}
+
+	for (i = 0U; i < ARRAY_SIZE(modes); i++) {
+		if ((mmc_flags & modes[i].flag) == 0U) {
+			continue;
+		}
+
+		/*
+		 * The set_ios() of a host without set_timing() may not
+		 * handle the DDR bus widths, so every mode needs it.
+		 */
+		if ((ops->set_timing == NULL) ||
+		    ((modes[i].timing == MMC_TIMING_HS400) &&
+		     (width != MMC_BUS_WIDTH_8)) ||
+		    ((modes[i].timing != MMC_TIMING_DDR52) &&
+		     (ops->execute_tuning == NULL))) {
+			continue;
+		}
+
+		ret = mmc_try_bus_mode(modes[i].timing, clk, width);
+		if (ret == 0) {
+			mmc_dev_info->timing = modes[i].timing;
+			break;
+		}
+
+		if (ret != -ENOTSUP) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static int sd_send_op_cond(void)
 {
 	int n;
@@ -494,10 +779,42 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		return ret;
 	}
 
-	return mmc_fill_device_info();
+	ret = mmc_fill_device_info();
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_select_bus_mode(clk, bus_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (mmc_dev_info->timing == MMC_TIMING_HS400) {
+		bus_width = MMC_BUS_WIDTH_8;
+	}
+
+	if ((mmc_dev_info->timing == MMC_TIMING_HS400) ||
+	    (mmc_dev_info->timing == MMC_TIMING_HS200)) {
+		clk = MMC_HS200_CLK_RATE;
+	} else if (mmc_dev_info->timing == MMC_TIMING_DDR52) {
+		clk = MMC_HS_CLK_RATE;
+	}
+
+	INFO("MMC: %s mode, %u-bit bus at %u Hz\n",
+	     mmc_timing_names[mmc_dev_info->timing],
+	     ((bus_width == MMC_BUS_WIDTH_8) ||
+	      (bus_width == MMC_BUS_WIDTH_DDR_8)) ? 8U :
+	     ((bus_width == MMC_BUS_WIDTH_1) ? 1U : 4U), clk);
+
+	return 0;
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+/*
+ * Start reading blocks: the data transfer is started, but not waited for. With
+ * a controller that reads by DMA, the CPU can work until mmc_read_blocks_wait()
+ * is called, which must be done before any other MMC operation.
+ */
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
@@ -507,9 +824,11 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	       (size != 0U) &&
 	       ((size & MMC_BLOCK_MASK) == 0U));
 
+	mmc_read_start = read_cntpct_el0();
+
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
 	if (is_cmd23_enabled()) {
@@ -517,7 +836,7 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		ret = mmc_send_cmd(MMC_CMD(23), size / MMC_BLOCK_SIZE,
 				   MMC_RESPONSE_R1, NULL);
 		if (ret != 0) {
-			return 0;
+			return ret;
 		}
 
 		cmd_idx = MMC_CMD(18);
@@ -536,10 +855,13 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		cmd_arg = lba;
 	}
 
-	ret = mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
-	if (ret != 0) {
-		return 0;
-	}
+	return mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
+}
+
+/* Wait for the read started by mmc_read_blocks_start() to complete */
+size_t mmc_read_blocks_wait(int lba, uintptr_t buf, size_t size)
+{
+	int ret;
 
 	ret = ops->read(lba, buf, size);
 	if (ret != 0) {
@@ -561,9 +883,21 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		}
 	}
 
+	mmc_read_bytes += size;
+	mmc_read_ticks += read_cntpct_el0() - mmc_read_start;
+
 	return size;
 }
 
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	if (mmc_read_blocks_start(lba, buf, size) != 0) {
+		return 0;
+	}
+
+	return mmc_read_blocks_wait(lba, buf, size);
+}
+
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	int ret;
@@ -710,6 +1044,30 @@ size_t mmc_rpmb_erase_blocks(int lba, size_t size)
 	return size_erased;
 }
 
+/*
+ * Print the bus mode and the throughput of the reads made since mmc_init(),
+ * to check the effect of the bus mode. A read started with
+ * mmc_read_blocks_start() is timed until mmc_read_blocks_wait() returns, so
+ * the work done meanwhile makes the throughput look lower.
+ */
+void mmc_print_read_stats(void)
+{
+	unsigned long long us;
+
+	if ((mmc_dev_info == NULL) || (mmc_read_ticks == 0U)) {
+		return;
+	}
+
+	us = (mmc_read_ticks * 1000000U) / read_cntfrq_el0();
+	if (us == 0U) {
+		us = 1U;
+	}
+
+	INFO("MMC: %s: read %llu KiB in %llu us (%llu KiB/s)\n",
+	     mmc_timing_names[mmc_dev_info->timing], mmc_read_bytes / 1024U,
+	     us, (mmc_read_bytes * 1000000U / 1024U) / us);
+}
+
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info)
@@ -732,6 +1090,8 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	ops = ops_ptr;
 	mmc_flags = flags;
 	mmc_dev_info = device_info;
+	mmc_read_bytes = 0U;
+	mmc_read_ticks = 0U;
 
 	return mmc_enumerate(clk, width);
 }
@@ -5,6 +5,9 @@
  */
 
 #include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -13,11 +16,35 @@
 #include <drivers/partition/partition.h>
 #include <drivers/partition/gpt.h>
 #include <drivers/partition/mbr.h>
+#include <lib/cassert.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
+#include <tf_crc32.h>
+
+/*
+ * Buffer the GPT header and entries are read through. Its size must be a
+ * power of two multiple of the block size.
+ */
+#ifndef PLAT_PARTITION_BUF_SIZE
+#define PLAT_PARTITION_BUF_SIZE		(8 * PARTITION_BLOCK_SIZE)
+#endif
+
+CASSERT(((PLAT_PARTITION_BUF_SIZE % PARTITION_BLOCK_SIZE) == 0) &&
+	((PLAT_PARTITION_BUF_SIZE & (PLAT_PARTITION_BUF_SIZE - 1)) == 0),
+	assert_plat_partition_buf_size);
+
+/* Twice the number of entries, so that probe sequences stay short */
+#define PARTITION_NAME_INDEX_SIZE	(2 * PLAT_PARTITION_MAX_ENTRIES)
 
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static uint8_t gpt_buf[PLAT_PARTITION_BUF_SIZE] __aligned(8);
 static partition_entry_list_t list;
 
+/* Index in list plus one of the partition in each slot, 0 if free */
+static uint8_t name_index[PARTITION_NAME_INDEX_SIZE];
+
+CASSERT(PLAT_PARTITION_MAX_ENTRIES < 255U, assert_partition_name_index_type);
+
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
 {
@@ -74,34 +101,60 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 }
 
 /*
- * Load GPT header and check the GPT signature.
- * If partition numbers could be found, check & update it.
+ * Load the GPT header at 'lba' and check its signature and CRC. Also check
+ * that its entry array can be read through gpt_buf.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, unsigned long long lba,
+			   gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
+	uint32_t crc;
 	int result;
 
-	result = io_seek(image_handle, IO_SEEK_SET, GPT_HEADER_OFFSET);
+	if (lba > ((unsigned long long)LONG_MAX / PARTITION_BLOCK_SIZE)) {
+		return -EINVAL;
+	}
+
+	result = io_seek(image_handle, IO_SEEK_SET,
+			 (ssize_t)(lba * PARTITION_BLOCK_SIZE));
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
-		return result;
+	result = io_read(image_handle, (uintptr_t)&gpt_buf,
+			 PARTITION_BLOCK_SIZE, &bytes_read);
+	if ((result != 0) || (bytes_read != PARTITION_BLOCK_SIZE)) {
+		return (result != 0) ? result : -EIO;
+	}
+
+	memcpy(header, gpt_buf, sizeof(gpt_header_t));
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+
+	if ((header->size < sizeof(gpt_header_t)) ||
+	    (header->size > PARTITION_BLOCK_SIZE)) {
 		return -EINVAL;
 	}
 
-	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
-	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
-		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
+	/* The CRC is computed with the CRC field itself zeroed */
+	zeromem(&gpt_buf[offsetof(gpt_header_t, header_crc)],
+		sizeof(header->header_crc));
+	crc = crc32(0UL, gpt_buf, header->size);
+	if ((crc != header->header_crc) || (header->current_lba != lba)) {
+		return -EINVAL;
 	}
+
+	/* Entries are a power of two in size, at least 128 bytes */
+	if ((header->part_size < sizeof(gpt_entry_t)) ||
+	    (header->part_size > sizeof(gpt_buf)) ||
+	    ((header->part_size & (header->part_size - 1U)) != 0U) ||
+	    (header->list_num == 0U) ||
+	    (header->part_lba >
+	     ((unsigned long long)LONG_MAX / PARTITION_BLOCK_SIZE))) {
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -156,45 +209,145 @@ static int load_mbr_entries(uintptr_t image_handle)
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the entry array of a GPT through gpt_buf, in as few transfers as it
+ * allows, and check its CRC. The entries are parsed up to the first unused
+ * one or up to PLAT_PARTITION_MAX_ENTRIES.
+ */
+static int load_gpt_entries(uintptr_t image_handle, const gpt_header_t *header)
 {
-	size_t bytes_read;
+	unsigned long long total;
+	unsigned long long offset;
+	size_t chunk, pos, bytes_read;
+	uint32_t crc = 0U;
+	int count = 0;
+	bool parsing = true;
 	int result;
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
-		return -EINVAL;
-	return result;
-}
+	result = io_seek(image_handle, IO_SEEK_SET,
+			 (ssize_t)(header->part_lba * PARTITION_BLOCK_SIZE));
+	if (result != 0) {
+		return result;
+	}
 
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
+	total = (unsigned long long)header->list_num * header->part_size;
+	for (offset = 0U; offset < total; offset += chunk) {
+		chunk = (size_t)MIN((unsigned long long)sizeof(gpt_buf),
+				    total - offset);
+		result = io_read(image_handle, (uintptr_t)&gpt_buf, chunk,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != chunk)) {
+			return (result != 0) ? result : -EIO;
+		}
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
+		crc = crc32(crc, gpt_buf, chunk);
+
+		/* part_size divides the size of gpt_buf */
+		for (pos = 0U; parsing && (pos < chunk);
+		     pos += header->part_size) {
+			if ((count == PLAT_PARTITION_MAX_ENTRIES) ||
+			    (parse_gpt_entry((gpt_entry_t *)&gpt_buf[pos],
+					     &list.list[count]) != 0)) {
+				parsing = false;
+			} else {
+				count++;
+			}
 		}
 	}
-	if (i == 0) {
+
+	if ((crc != header->part_crc) || (count == 0)) {
 		return -EINVAL;
 	}
+
 	/*
 	 * Only records the valid partition number that is loaded from
 	 * partition table.
 	 */
-	list.entry_count = i;
+	list.entry_count = count;
 	dump_entries(list.entry_count);
 
 	return 0;
 }
 
+/* Load the primary GPT, or the backup one if the primary is invalid */
+static int load_gpt(uintptr_t image_handle)
+{
+	gpt_header_t header;
+	unsigned long long backup_lba = 0U;
+	size_t size;
+	int result;
+
+	result = load_gpt_header(image_handle, GPT_HEADER_OFFSET /
+				 PARTITION_BLOCK_SIZE, &header);
+	if (result == 0) {
+		backup_lba = header.backup_lba;
+		result = load_gpt_entries(image_handle, &header);
+		if (result == 0) {
+			return 0;
+		}
+	}
+
+	WARN("Primary GPT is invalid (%i), using the backup GPT\n", result);
+
+	/* Without a valid primary header, the backup is in the last block */
+	if (backup_lba == 0U) {
+		result = io_size(image_handle, &size);
+		if ((result != 0) || (size < PARTITION_BLOCK_SIZE)) {
+			WARN("Failed to locate the backup GPT (%i)\n", result);
+			return -ENOENT;
+		}
+		backup_lba = (size / PARTITION_BLOCK_SIZE) - 1U;
+	}
+
+	result = load_gpt_header(image_handle, backup_lba, &header);
+	if (result == 0) {
+		result = load_gpt_entries(image_handle, &header);
+	}
+	if (result != 0) {
+		WARN("Backup GPT is invalid (%i)\n", result);
+	}
+
+	return result;
+}
+
+/* FNV-1a hash of a partition name */
+static uint32_t partition_name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Index the partitions by name in an open addressing hash table. When
+ * several partitions have the same name, the first one is indexed.
+ */
+static void build_name_index(void)
+{
+	unsigned int slot;
+	int i;
+
+	zeromem(name_index, sizeof(name_index));
+
+	for (i = 0; i < list.entry_count; i++) {
+		slot = partition_name_hash(list.list[i].name) %
+		       PARTITION_NAME_INDEX_SIZE;
+		while ((name_index[slot] != 0U) &&
+		       (strcmp(list.list[name_index[slot] - 1U].name,
+			       list.list[i].name) != 0)) {
+			slot = (slot + 1U) % PARTITION_NAME_INDEX_SIZE;
+		}
+		if (name_index[slot] == 0U) {
+			name_index[slot] = (uint8_t)(i + 1);
+		}
+	}
+}
+
 int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
@@ -217,17 +370,19 @@ int load_partition_table(unsigned int image_id)
 	result = load_mbr_header(image_handle, &mbr_entry);
 	if (result != 0) {
 		WARN("Failed to access image id=%u (%i)\n", image_id, result);
+		io_close(image_handle);
 		return result;
 	}
+	list.entry_count = 0;
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
-		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
-		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = load_gpt(image_handle);
 	} else {
 		result = load_mbr_entries(image_handle);
 	}
+	if (result != 0) {
+		list.entry_count = 0;
+	}
+	build_name_index();
 
 	io_close(image_handle);
 	return result;
@@ -235,12 +390,15 @@ int load_partition_table(unsigned int image_id)
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int slot;
+	uint8_t index;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	slot = partition_name_hash(name) % PARTITION_NAME_INDEX_SIZE;
+	for (index = name_index[slot]; index != 0U; index = name_index[slot]) {
+		if (strcmp(name, list.list[index - 1U].name) == 0) {
+			return &list.list[index - 1U];
 		}
+		slot = (slot + 1U) % PARTITION_NAME_INDEX_SIZE;
 	}
 	return NULL;
 }
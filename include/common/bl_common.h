@@ -223,12 +223,38 @@ typedef struct bl_params_node {
 typedef struct bl_params {
 	param_header_t h;
 	bl_params_node_t *head;
+	/*
+	 * Boot-time records of the previous stages (BOOT_INSTR_TOTAL_IDS
+	 * entries) or NULL. Check 'h.size' before reading it.
+	 */
+	const unsigned long long *boot_instr;
 } bl_params_t;
 
+/*
+ * Consumer of the data of an image loaded by load_auth_image(). The image is
+ * read in chunks into [buf_base, buf_base + buf_size) and each chunk is passed
+ * to write() instead of being kept at image_base. start() is called once the
+ * size of the image is known, and the image is no larger than image_max_size.
+ * If anything fails after start() has succeeded, including the authentication
+ * of the image, abort() is called to wipe what write() has produced.
+ *
+ * The image is only authenticated once all of it has been read, so write()
+ * works on data that may have been tampered with and must not write outside
+ * the memory reserved for the image, whatever that data is.
+ */
+typedef struct image_load_stream {
+	uintptr_t buf_base;
+	size_t buf_size;
+	int (*start)(size_t image_size);
+	int (*write)(uintptr_t buf, size_t len);
+	void (*abort)(void);
+} image_load_stream_t;
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+void set_image_load_stream(const image_load_stream_t *stream);
 
 #if TRUSTED_BOARD_BOOT && defined(DYN_DISABLE_AUTH)
 /*
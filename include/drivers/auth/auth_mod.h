@@ -13,6 +13,7 @@
 #include <common/tbbr/tbbr_img_def.h>
 #include <drivers/auth/auth_common.h>
 #include <drivers/auth/img_parser_mod.h>
+#include <lib/utils_def.h>
 
 /*
  * Image flags
@@ -33,17 +34,22 @@ typedef struct auth_img_desc_s {
 
 /* Public functions */
 void auth_mod_init(void);
+void auth_mod_exit(void);
 int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_start(unsigned int img_id);
+void auth_mod_hash_update(void *data_ptr, unsigned int data_len);
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
 	const auth_img_desc_t *const *const cot_desc_ptr = (_cot); \
+	const unsigned int cot_desc_size = ARRAY_SIZE(_cot); \
 	unsigned int auth_img_flags[MAX_NUMBER_IDS]
 
 extern const auth_img_desc_t *const *const cot_desc_ptr;
+extern const unsigned int cot_desc_size;
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
 #endif /* TRUSTED_BOARD_BOOT */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -37,6 +37,15 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional incremental version of verify_hash(). Only one hash can be
+	 * in progress at a time. hash_start() takes the expected DigestInfo,
+	 * hash_update() may be called any number of times and hash_finish()
+	 * compares the result and releases the context. hash_start() and
+	 * hash_finish() return one of the 'enum crypto_ret_value' options */
+	int (*hash_start)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_finish)(void);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,6 +56,9 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_finish(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -57,6 +69,20 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library that can hash incrementally */
+#define REGISTER_CRYPTO_LIB_HASH_STREAM(_name, _init, _verify_signature, \
+					_verify_hash, _hash_start, \
+					_hash_update, _hash_finish) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_start = _hash_start, \
+		.hash_update = _hash_update, \
+		.hash_finish = _hash_finish \
+	}
+
 extern const crypto_lib_desc_t crypto_lib_desc;
 
 #endif /* CRYPTO_MOD_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -70,6 +70,10 @@
 #endif
 
 #define MBEDTLS_SHA256_C
+#if TF_MBEDTLS_USE_SHA256_CE
+/* Use the ARMv8 Cryptographic Extension for the SHA-256 block function */
+#define MBEDTLS_SHA256_PROCESS_ALT
+#endif
 #if (TF_MBEDTLS_HASH_ALG_ID != TF_MBEDTLS_SHA256)
 #define MBEDTLS_SHA512_C
 #endif
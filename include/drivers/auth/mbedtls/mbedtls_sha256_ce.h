@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MBEDTLS_SHA256_CE_H
+#define MBEDTLS_SHA256_CE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void sha256_ce_process(uint32_t state[8], const unsigned char *data,
+		       size_t blocks);
+void mbedtls_sha256_ce_init(void);
+
+#endif /* MBEDTLS_SHA256_CE_H */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BUFFERED_CONSOLE_H
+#define BUFFERED_CONSOLE_H
+
+#include <lib/utils_def.h>
+
+/*
+ * The log region of a buffered console holds one ring per CPU, laid out one
+ * after the other. Each ring is a header followed by its data. The layout is
+ * fixed so that the normal world or a debugger can read the log from memory:
+ * the last MIN(head, size) characters written are at data[i % size] for i
+ * from head - MIN(head, size) to head - 1. The console keeps its own copy of
+ * head and tail, the ones in the log region are only written.
+ */
+#define CONSOLE_LOG_RING_MAGIC		U(0x474f4c43)	/* "CLOG" */
+
+#define CONSOLE_LOG_RING_T_MAGIC	U(0)
+#define CONSOLE_LOG_RING_T_SIZE		U(4)
+#define CONSOLE_LOG_RING_T_HEAD		U(8)
+#define CONSOLE_LOG_RING_T_TAIL		U(16)
+#define CONSOLE_LOG_RING_T_DATA		U(24)
+
+/* Size of one ring in the log region, for a data size of 'size' */
+#define CONSOLE_LOG_RING_STRIDE(size)	(CONSOLE_LOG_RING_T_DATA + (size))
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+#include <drivers/console.h>
+
+typedef struct console_log_ring {
+	uint32_t magic;
+	/* Size of data[], a power of two */
+	uint32_t size;
+	/* Number of characters written to the ring */
+	volatile uint64_t head;
+	/* Number of characters sent to the UART */
+	volatile uint64_t tail;
+	uint8_t data[];
+} console_log_ring_t;
+
+/*
+ * Write up to 'len' characters from 'buf' to the backend console without
+ * waiting, and return how many were written.
+ */
+typedef int (*console_tx_burst_t)(console_t *backend, const uint8_t *buf,
+				  unsigned int len);
+
+/*
+ * Make the registered console 'backend' buffered: characters printed on a CPU
+ * are stored in that CPU's ring in the log region, and are sent to 'backend'
+ * through 'tx_burst' whenever the UART has room for them. Printing only waits
+ * for the UART when the ring of the CPU is full.
+ *
+ * The log region at 'log_base' must hold PLATFORM_CORE_COUNT rings of
+ * 'ring_size' bytes of data, i.e. PLATFORM_CORE_COUNT *
+ * CONSOLE_LOG_RING_STRIDE(ring_size) bytes. 'ring_size' must be a power of
+ * two. The boot and runtime scopes of 'backend' move to the buffered console,
+ * 'backend' keeps the crash scope.
+ *
+ * Returns 1 on success, 0 on error.
+ */
+int console_buffered_register(console_t *backend, console_tx_burst_t tx_burst,
+			      uintptr_t log_base, unsigned int ring_size);
+
+/* Send what the UART has room for, without waiting. */
+void console_buffered_drain(void);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* BUFFERED_CONSOLE_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,8 +9,24 @@
 
 #include <stdint.h>
 
+#include <arch_helpers.h>
+
 void generic_delay_timer_init_args(uint32_t mult, uint32_t div);
 
 void generic_delay_timer_init(void);
 
+/*
+ * Convert a number of system counter ticks to microseconds. Returns 0 if the
+ * counter frequency has not been programmed.
+ */
+static inline unsigned int generic_delay_timer_ticks_to_us(uint64_t ticks)
+{
+	uint64_t freq = read_cntfrq_el0();
+
+	if (freq == 0U)
+		return 0U;
+
+	return (unsigned int)((ticks * 1000000ULL) / freq);
+}
+
 #endif /* GENERIC_DELAY_TIMER_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,16 +9,31 @@
 
 #include <drivers/io/io_storage.h>
 
-/* block devices ops */
+/*
+ * block devices ops. read_start() and read_wait() are optional, they split a
+ * read into starting the transfer and waiting for it so that the CPU can work
+ * in between. read_start() returns 0 if the transfer was started and
+ * read_wait() the number of bytes read, like read().
+ */
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	int	(*read_start)(int lba, uintptr_t buf, size_t size);
+	size_t	(*read_wait)(int lba, uintptr_t buf, size_t size);
 } io_block_ops_t;
 
+/*
+ * Flags of a block device. IO_BLOCK_DIRECT_READ allows ops.read() to be given
+ * any block-aligned destination, not only the buffer of the device, so that
+ * whole blocks are read straight into the caller's buffer.
+ */
+#define IO_BLOCK_DIRECT_READ	(1U << 0)
+
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	unsigned int	flags;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
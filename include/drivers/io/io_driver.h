@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -43,6 +43,10 @@ typedef struct io_dev_funcs {
 	int (*size)(io_entity_t *entity, size_t *length);
 	int (*read)(io_entity_t *entity, uintptr_t buffer, size_t length,
 			size_t *length_read);
+	int (*map)(io_entity_t *entity, size_t length, uintptr_t *addr);
+	int (*read_start)(io_entity_t *entity, uintptr_t buffer,
+			size_t length);
+	int (*read_wait)(io_entity_t *entity, size_t *length_read);
 	int (*write)(io_entity_t *entity, const uintptr_t buffer,
 			size_t length, size_t *length_written);
 	int (*close)(io_entity_t *entity);
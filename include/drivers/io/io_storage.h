@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -96,6 +96,16 @@ int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
 int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 		size_t *length_written);
 
+/* Get the address of data in an entity of a memory-mapped device, so that it
+ * can be accessed without being read */
+int io_map(uintptr_t handle, size_t length, uintptr_t *addr);
+
+/* Asynchronous read: start reading data from an entity, do something else,
+ * then wait for the read to complete before using the entity again */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length);
+
+int io_read_wait(uintptr_t handle, size_t *length_read);
+
 int io_close(uintptr_t handle);
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -14,6 +14,8 @@
 #define MMC_BLOCK_SIZE			U(512)
 #define MMC_BLOCK_MASK			(MMC_BLOCK_SIZE - U(1))
 #define MMC_BOOT_CLK_RATE		(400 * 1000)
+#define MMC_HS_CLK_RATE			(52 * 1000 * 1000)
+#define MMC_HS200_CLK_RATE		(200 * 1000 * 1000)
 
 #define MMC_CMD(_x)			U(_x)
 
@@ -60,6 +62,7 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_SEC_CNT		212
 
 #define PART_CFG_BOOT_PARTITION1_ENABLE	(U(1) << 3)
@@ -74,6 +77,18 @@
 #define MMC_BOOT_MODE_BACKWARD		(U(0) << 3)
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
+#define MMC_HS_TIMING_BACKWARD		U(0)
+#define MMC_HS_TIMING_HS		U(1)
+#define MMC_HS_TIMING_HS200		U(2)
+#define MMC_HS_TIMING_HS400		U(3)
+#define MMC_DEVICE_TYPE_HS_26		BIT(0)
+#define MMC_DEVICE_TYPE_HS_52		BIT(1)
+#define MMC_DEVICE_TYPE_DDR52_1V8	BIT(2)	/* also 3.3 V */
+#define MMC_DEVICE_TYPE_DDR52_1V2	BIT(3)
+#define MMC_DEVICE_TYPE_HS200_1V8	BIT(4)
+#define MMC_DEVICE_TYPE_HS200_1V2	BIT(5)
+#define MMC_DEVICE_TYPE_HS400_1V8	BIT(6)
+#define MMC_DEVICE_TYPE_HS400_1V2	BIT(7)
 
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
@@ -104,6 +119,14 @@
 #define MMC_STATE_SLP			10
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
+/* eMMC bus modes supported by the host, used if the card supports them too */
+#define MMC_FLAG_DDR52			(U(1) << 1)
+#define MMC_FLAG_HS200			(U(1) << 2)
+#define MMC_FLAG_HS400			(U(1) << 3)
+
+/* I/O signal voltages passed to mmc_ops.set_voltage(), in mV */
+#define MMC_SIGNAL_VOLTAGE_180		U(1800)
+#define MMC_SIGNAL_VOLTAGE_120		U(1200)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
@@ -118,6 +141,14 @@ struct mmc_cmd {
 	unsigned int	resp_data[4];
 };
 
+/* Bus timings of the eMMC modes */
+enum mmc_timing {
+	MMC_TIMING_LEGACY,
+	MMC_TIMING_DDR52,
+	MMC_TIMING_HS200,
+	MMC_TIMING_HS400,
+};
+
 struct mmc_ops {
 	void (*init)(void);
 	int (*send_cmd)(struct mmc_cmd *cmd);
@@ -125,6 +156,18 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional. set_timing() is called before set_ios() when the bus
+	 * timing changes. DDR52, HS200 and HS400 are only used if the host has
+	 * it, and set_ios() is then given the DDR bus widths in DDR52 and
+	 * HS400. HS200 and HS400 also need execute_tuning(), which runs the
+	 * tuning sequence (CMD21) once the bus is at the HS200 clock.
+	 * set_voltage() switches the I/O voltage. Without it, the I/O voltage
+	 * is assumed to be 1.8 V when HS200 or HS400 are enabled.
+	 */
+	int (*set_timing)(enum mmc_timing timing);
+	int (*execute_tuning)(void);
+	int (*set_voltage)(unsigned int mv);
 };
 
 struct mmc_csd_emmc {
@@ -222,9 +265,12 @@ struct mmc_device_info {
 	unsigned int		max_bus_freq;	/* Max bus freq in Hz */
 	unsigned int		ocr_voltage;	/* OCR voltage */
 	enum mmc_device_type	mmc_dev_type;	/* Type of MMC */
+	enum mmc_timing		timing;		/* Bus timing in use */
 };
 
 size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size);
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t mmc_read_blocks_wait(int lba, uintptr_t buf, size_t size);
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_erase_blocks(int lba, size_t size);
 size_t mmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
@@ -233,5 +279,6 @@ size_t mmc_rpmb_erase_blocks(int lba, size_t size);
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info);
+void mmc_print_read_stats(void);
 
 #endif /* MMC_H */
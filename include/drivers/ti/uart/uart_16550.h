@@ -71,6 +71,11 @@
 #define UARTLSR_RDR_BIT		(0)		/* Rx Data Ready Bit */
 #define UARTLSR_RDR		(1 << UARTLSR_RDR_BIT)	/* Rx Data Ready */
 
+/* Depth of the transmit FIFO, 16 bytes on a standard 16550 */
+#ifndef UART_16550_TX_FIFO_DEPTH
+#define UART_16550_TX_FIFO_DEPTH	16
+#endif
+
 #define CONSOLE_T_16550_BASE	CONSOLE_T_DRVDATA
 
 #ifndef __ASSEMBLY__
@@ -91,6 +96,15 @@ typedef struct {
 int console_16550_register(uintptr_t baseaddr, uint32_t clock, uint32_t baud,
 			   console_16550_t *console);
 
+/*
+ * Write up to |len| characters from |buf| without waiting for the UART. If
+ * the transmit FIFO is empty, it is filled with as many characters as fit,
+ * '\n' taking two entries since it is sent as "\r\n". Return the number of
+ * characters of |buf| consumed, 0 if the FIFO isn't empty yet.
+ */
+int console_16550_tx_burst(console_t *console, const uint8_t *buf,
+			   unsigned int len);
+
 #endif /*__ASSEMBLY__*/
 
 #endif /* UART_16550_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,15 +9,24 @@
 
 #include <platform_def.h>
 
+#include <lib/utils_def.h>
+
 #define BAKERY_LOCK_MAX_CPUS		PLATFORM_CORE_COUNT
 
+#if USE_QUEUED_BAKERY_LOCKS
+/*
+ * Size of the data of one CPU for one lock in the bakery_lock section, and of
+ * the queue that the linker script allocates for each of these locks.
+ */
+#define BAKERY_INFO_SIZE		U(2)
+#define BAKERY_QUEUE_SIZE		(U(4) * CACHE_WRITEBACK_GRANULE)
+#endif
+
 #ifndef __ASSEMBLY__
 #include <cdefs.h>
 #include <stdbool.h>
 #include <stdint.h>
 
-#include <lib/utils_def.h>
-
 /*****************************************************************************
  * Internal helpers used by the bakery lock implementation.
  ****************************************************************************/
@@ -48,6 +57,10 @@ static inline uint16_t make_bakery_data(unsigned int choosing, unsigned int num)
 	return (uint16_t) val;
 }
 
+#if USE_QUEUED_BAKERY_LOCKS
+uintptr_t bakery_queue_swap(volatile uintptr_t *tail, uintptr_t node);
+#endif
+
 /*****************************************************************************
  * External bakery lock interface.
  ****************************************************************************/
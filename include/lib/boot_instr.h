@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BOOT_INSTR_H
+#define BOOT_INSTR_H
+
+#include <lib/utils_def.h>
+
+/*
+ * Time-stamp ids of the boot-time instrumentation PMF service. The stage
+ * entry/exit ids hold system counter values. All other ids hold durations in
+ * system counter ticks.
+ */
+#define BOOT_INSTR_BL1_ENTRY		U(0)
+#define BOOT_INSTR_BL2_ENTRY		U(1)
+#define BOOT_INSTR_BL31_ENTRY		U(2)
+#define BOOT_INSTR_BL31_EXIT		U(3)
+
+/*
+ * Each stage gets its own set of BOOT_INSTR_STEPS ids for the platform steps,
+ * starting at BOOT_INSTR_STEP_BASE, so that the records a stage hands over to
+ * the next one never overlap with the ones the next stage writes itself.
+ */
+#define BOOT_INSTR_STEP_BASE		U(4)
+#define BOOT_INSTR_STEP_CONSOLE		U(0)
+#define BOOT_INSTR_STEP_DDR		U(1)
+#define BOOT_INSTR_STEPS		U(2)
+
+#define BOOT_INSTR_STAGE_BL1		U(0)
+#define BOOT_INSTR_STAGE_BL2		U(1)
+#define BOOT_INSTR_STAGE_BL31		U(2)
+#define BOOT_INSTR_STAGES		U(3)
+
+#define BOOT_INSTR_STEP_ID(stage, step)	(BOOT_INSTR_STEP_BASE + \
+					 ((stage) * BOOT_INSTR_STEPS) + (step))
+
+/* Step ids of the stage being built */
+#if defined(IMAGE_BL1)
+#define BOOT_INSTR_STAGE		BOOT_INSTR_STAGE_BL1
+#elif defined(IMAGE_BL2)
+#define BOOT_INSTR_STAGE		BOOT_INSTR_STAGE_BL2
+#elif defined(IMAGE_BL31)
+#define BOOT_INSTR_STAGE		BOOT_INSTR_STAGE_BL31
+#endif
+
+#ifdef BOOT_INSTR_STAGE
+#define BOOT_INSTR_CONSOLE_INIT		BOOT_INSTR_STEP_ID(BOOT_INSTR_STAGE, \
+						BOOT_INSTR_STEP_CONSOLE)
+#define BOOT_INSTR_DDR_INIT		BOOT_INSTR_STEP_ID(BOOT_INSTR_STAGE, \
+						BOOT_INSTR_STEP_DDR)
+#endif
+
+/*
+ * Each image loaded by a stage gets a record of BOOT_INSTR_IMAGE_FIELDS ids,
+ * starting at BOOT_INSTR_IMAGE_BASE. The first one holds the image id plus
+ * one, so that unused records read as 0. The time spent loading and
+ * authenticating the parent certificates of an image is accounted to it.
+ * BOOT_INSTR_IMAGE_OVERLAP is the time spent hashing while the device was
+ * reading the next chunk in the background, which READ doesn't include.
+ */
+#define BOOT_INSTR_IMAGE_BASE		(BOOT_INSTR_STEP_BASE + \
+					 (BOOT_INSTR_STAGES * BOOT_INSTR_STEPS))
+#define BOOT_INSTR_IMAGE_ID		U(0)
+#define BOOT_INSTR_IMAGE_OPEN		U(1)
+#define BOOT_INSTR_IMAGE_READ		U(2)
+#define BOOT_INSTR_IMAGE_AUTH		U(3)
+#define BOOT_INSTR_IMAGE_DECOMPRESS	U(4)
+#define BOOT_INSTR_IMAGE_OVERLAP	U(5)
+#define BOOT_INSTR_IMAGE_FIELDS		U(6)
+#define BOOT_INSTR_MAX_IMAGES		U(8)
+
+#define BOOT_INSTR_TOTAL_IDS		(BOOT_INSTR_IMAGE_BASE + \
+					 (BOOT_INSTR_MAX_IMAGES * \
+					  BOOT_INSTR_IMAGE_FIELDS))
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+
+#include <arch_helpers.h>
+
+#if ENABLE_BOOT_INSTRUMENTATION
+static inline unsigned long long boot_instr_now(void)
+{
+	return read_cntpct_el0();
+}
+
+void boot_instr_mark(unsigned int tid);
+void boot_instr_add(unsigned int tid, unsigned long long start);
+void boot_instr_image_begin(unsigned int image_id);
+void boot_instr_image_add(unsigned int field, unsigned long long start);
+const unsigned long long *boot_instr_export(void);
+void boot_instr_import(const unsigned long long *records);
+void boot_instr_print_summary(void);
+#else
+static inline unsigned long long boot_instr_now(void)
+{
+	return 0ULL;
+}
+
+static inline void boot_instr_mark(unsigned int tid)
+{
+}
+
+static inline void boot_instr_add(unsigned int tid, unsigned long long start)
+{
+}
+
+static inline void boot_instr_image_begin(unsigned int image_id)
+{
+}
+
+static inline void boot_instr_image_add(unsigned int field,
+					unsigned long long start)
+{
+}
+
+static inline const unsigned long long *boot_instr_export(void)
+{
+	return NULL;
+}
+
+static inline void boot_instr_import(const unsigned long long *records)
+{
+}
+
+static inline void boot_instr_print_summary(void)
+{
+}
+#endif /* ENABLE_BOOT_INSTRUMENTATION */
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* BOOT_INSTR_H */
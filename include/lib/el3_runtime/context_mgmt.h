@@ -46,6 +46,14 @@ void cm_write_scr_el3_bit(uint32_t security_state,
 			  uint32_t value);
 void cm_set_next_eret_context(uint32_t security_state);
 uint32_t cm_get_scr_el3(uint32_t security_state);
+#if CTX_INCLUDE_FPREGS
+void cm_fpregs_context_save(uint32_t security_state);
+void cm_fpregs_context_restore(uint32_t security_state);
+#endif
+#if CTX_LAZY_FPREGS
+void cm_fpregs_lazy_switch(cpu_context_t *ctx);
+void cm_fpregs_lazy_flush(void);
+#endif
 
 /* Inline definitions */
 
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_H
+#define EL3_TRACE_H
+
+#include <lib/utils_def.h>
+
+/*
+ * Time-stamp ids of the EL3 trace PMF service. They let the normal world find
+ * the trace region through the PMF SMC interface: the ids return the base
+ * address of the region, the number of events of each ring, and the number of
+ * events written so far to the ring of the CPU given by the MPIDR.
+ */
+#define EL3_TRACE_TID_BASE		U(0)
+#define EL3_TRACE_TID_RING_SIZE		U(1)
+#define EL3_TRACE_TID_HEAD		U(2)
+#define EL3_TRACE_TOTAL_IDS		U(3)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <tools_share/el3_trace_ring.h>
+
+#if ENABLE_EL3_TRACE
+void el3_trace_init(void);
+void el3_trace_event(unsigned int id, u_register_t arg0, u_register_t arg1);
+void el3_trace_smc_entry(uint32_t smc_fid, u_register_t x1,
+			 u_register_t flags);
+void el3_trace_smc_exit(uint32_t smc_fid, void *handle, u_register_t flags);
+#else
+static inline void el3_trace_init(void)
+{
+}
+
+static inline void el3_trace_event(unsigned int id, u_register_t arg0,
+				   u_register_t arg1)
+{
+}
+#endif /* ENABLE_EL3_TRACE */
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* EL3_TRACE_H */
@@ -16,6 +16,8 @@ typedef struct spinlock {
 } spinlock_t;
 
 void spin_lock(spinlock_t *lock);
+/* Returns 1 if the lock was acquired, 0 if it is already held. */
+int spin_trylock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
 #else
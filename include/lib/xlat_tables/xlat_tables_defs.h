@@ -44,6 +44,9 @@
 
 #define DESC_MASK		U(0x3)
 
+/* A descriptor with this bit clear is invalid, whatever its other bits are */
+#define DESC_VALID_BIT		ULL(0x1)
+
 #define FIRST_LEVEL_DESC_N	ONE_GB_SHIFT
 #define SECOND_LEVEL_DESC_N	TWO_MB_SHIFT
 #define THIRD_LEVEL_DESC_N	FOUR_KB_SHIFT
@@ -90,6 +93,13 @@
 
 #define XLAT_TABLE_LEVEL_MAX	U(3)
 
+/*
+ * Number of adjacent block or page descriptors of a table that can be marked
+ * with the contiguous hint, with the 4KB translation granule. The TLB may then
+ * cache the whole run as a single entry.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
+
 /* Values for number of entries in each MMU translation table */
 #define XLAT_TABLE_ENTRIES_SHIFT (XLAT_TABLE_SIZE_SHIFT - XLAT_ENTRY_SIZE_SHIFT)
 #define XLAT_TABLE_ENTRIES	(U(1) << XLAT_TABLE_ENTRIES_SHIFT)
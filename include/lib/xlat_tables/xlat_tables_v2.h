@@ -340,11 +340,28 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  * NOTE2: The caller is responsible for making sure that the targeted
  * translation tables are not modified by any other code while this function is
  * executing.
+ *
+ * NOTE3: All the pages whose attributes change are unmapped at the same time
+ * while their descriptors are rewritten, so the memory region must not hold
+ * the code, stack or translation tables used by the caller. With
+ * XLAT_TABLES_CONT_HINT, this extends to the pages around the region that
+ * share a contiguous run with it.
  */
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr);
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr);
 
+/*
+ * Same as xlat_change_mem_attributes_ctx(). In addition, on success, the number
+ * of pages of the region whose descriptors were rewritten is stored into
+ * *changed if it isn't NULL. Pages around the region that only lose the
+ * contiguous hint are not counted. Pages that already have the requested
+ * attributes are left untouched, and no TLB maintenance is done if there are
+ * none to change.
+ */
+int xlat_change_mem_attributes_range_ctx(const xlat_ctx_t *ctx,
+		uintptr_t base_va, size_t size, uint32_t attr, size_t *changed);
+
 /*
  * Query the memory attributes of a memory page in a set of translation tables.
  *
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_CRC32_H
+#define TF_CRC32_H
+
+/*
+ * CRC-32 (IEEE 802.3) of buf, continued from a previous value of crc.
+ * Implemented by lib/zlib/crc32.c; start with a crc of 0.
+ */
+unsigned long crc32(unsigned long crc, const unsigned char *buf,
+		    unsigned int len);
+
+#endif /* TF_CRC32_H */
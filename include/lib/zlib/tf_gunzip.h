@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,7 +10,18 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * Workspace needed by gunzip_stream_start(): the inflate state and the 32KB
+ * sliding window.
+ */
+#define GUNZIP_STREAM_WORK_SIZE		0xa000
+
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+int gunzip_stream_start(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+			size_t work_len);
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len);
+int gunzip_stream_finish(uintptr_t *out_buf);
+
 #endif /* TF_GUNZIP_H */
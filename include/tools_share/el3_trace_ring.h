@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_RING_H
+#define EL3_TRACE_RING_H
+
+#include <stdint.h>
+
+/*
+ * The EL3 trace region holds one ring of events per CPU, laid out one after
+ * the other. Each ring is a header followed by its events, the header being
+ * as large as an event. The event written at position i of a ring is at
+ * events[i % size], and it is valid when its seq field is (i + 1) modulo 2^32
+ * both before and after reading the other fields.
+ */
+#define EL3_TRACE_RING_MAGIC		0x52543345U	/* "E3TR" */
+
+#define EL3_TRACE_RING_HDR_SIZE		32U
+#define EL3_TRACE_EVENT_SIZE		32U
+
+/* Size of one ring in the trace region, for 'size' events */
+#define EL3_TRACE_RING_STRIDE(size)	(EL3_TRACE_RING_HDR_SIZE + \
+					 ((size) * EL3_TRACE_EVENT_SIZE))
+
+/*
+ * Event ids, and the meaning of their arguments. The timestamps are system
+ * counter values. Arguments that belong to the secure world read as 0: the
+ * function id and x1 of SMCs from the secure world, x0 returned to the secure
+ * world, and ELR_EL3 when switching to the secure world.
+ */
+#define EL3_TRACE_SMC_ENTRY		1U	/* function id, x1 */
+#define EL3_TRACE_SMC_EXIT		2U	/* function id, returned x0 */
+#define EL3_TRACE_INTR_ENTRY		3U	/* interrupt id, priority */
+#define EL3_TRACE_INTR_EXIT		4U	/* interrupt id, handler result */
+#define EL3_TRACE_PSCI_CPU_OFF		5U	/* last power level, 0 */
+#define EL3_TRACE_PSCI_SUSPEND		6U	/* last power level, power down */
+#define EL3_TRACE_PSCI_WAKEUP		7U	/* last power level, power down */
+#define EL3_TRACE_WORLD_SWITCH		8U	/* security state, ELR_EL3 */
+
+typedef struct el3_trace_event {
+	/* Position of the event in the ring plus one, 0 while it is written */
+	uint32_t seq;
+	uint32_t id;
+	uint64_t timestamp;
+	uint64_t arg0;
+	uint64_t arg1;
+} el3_trace_event_t;
+
+typedef struct el3_trace_ring {
+	uint32_t magic;
+	/* Number of events of the ring, a power of two */
+	uint32_t size;
+	/* Number of events written to the ring */
+	uint64_t head;
+	/* Frequency of the system counter, in Hz */
+	uint64_t freq;
+	uint64_t reserved;
+	el3_trace_event_t events[];
+} el3_trace_ring_t;
+
+#endif /* EL3_TRACE_RING_H */
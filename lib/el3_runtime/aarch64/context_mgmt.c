@@ -17,6 +17,7 @@
 #include <context.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace.h>
 #include <lib/extensions/amu.h>
 #include <lib/extensions/mpam.h>
 #include <lib/extensions/spe.h>
@@ -47,6 +48,39 @@ void __init cm_init(void)
 	 */
 }
 
+#if CTX_LAZY_FPREGS && IMAGE_BL31
+/*
+ * Context whose FP registers are live in the FP registers of each CPU, or NULL
+ * if the live registers are also saved in the context they belong to.
+ */
+static cpu_context_t *fpregs_owner[PLATFORM_CORE_COUNT];
+
+/*
+ * Forget that 'ctx' owns the live FP registers of 'cpu_idx' when the context is
+ * about to be initialised, so that they are not saved over the new context.
+ */
+static void fpregs_drop_owner(unsigned int cpu_idx, const cpu_context_t *ctx)
+{
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	if (fpregs_owner[cpu_idx] == ctx)
+		fpregs_owner[cpu_idx] = NULL;
+}
+
+/* Trap FP accesses from 'ctx' unless it owns the live FP registers */
+static void fpregs_set_trap(const cpu_context_t *ctx)
+{
+	u_register_t cptr_el3 = read_cptr_el3();
+
+	if (fpregs_owner[plat_my_core_pos()] == ctx)
+		cptr_el3 &= ~TFP_BIT;
+	else
+		cptr_el3 |= TFP_BIT;
+
+	write_cptr_el3(cptr_el3);
+}
+#endif /* CTX_LAZY_FPREGS && IMAGE_BL31 */
+
 /*******************************************************************************
  * The following function initializes the cpu_context 'ctx' for
  * first use, and sets the initial entrypoint state as specified by the
@@ -286,6 +320,9 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 {
 	cpu_context_t *ctx;
 	ctx = cm_get_context_by_index(cpu_idx, GET_SECURITY_STATE(ep->h.attr));
+#if CTX_LAZY_FPREGS && IMAGE_BL31
+	fpregs_drop_owner(cpu_idx, ctx);
+#endif
 	cm_setup_context(ctx, ep);
 }
 
@@ -298,6 +335,9 @@ void cm_init_my_context(const entry_point_info_t *ep)
 {
 	cpu_context_t *ctx;
 	ctx = cm_get_context(GET_SECURITY_STATE(ep->h.attr));
+#if CTX_LAZY_FPREGS && IMAGE_BL31
+	fpregs_drop_owner(plat_my_core_pos(), ctx);
+#endif
 	cm_setup_context(ctx, ep);
 }
 
@@ -629,5 +669,99 @@ void cm_set_next_eret_context(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
+#if CTX_LAZY_FPREGS && IMAGE_BL31
+	fpregs_set_trap(ctx);
+#endif
+
+	/* The return address of the secure world is not recorded */
+	el3_trace_event(EL3_TRACE_WORLD_SWITCH, security_state,
+			(security_state == NON_SECURE) ?
+			read_ctx_reg(get_el3state_ctx(ctx), CTX_ELR_EL3) : 0U);
+
 	cm_set_next_context(ctx);
 }
+
+#if CTX_INCLUDE_FPREGS
+/*******************************************************************************
+ * The following functions are used by secure payload dispatchers to switch the
+ * FP register context of the given security state around a world switch. With
+ * CTX_LAZY_FPREGS the registers are only switched when a lower EL accesses
+ * them, see cm_fpregs_lazy_switch(), so saving and restoring is left to
+ * cm_set_next_eret_context().
+ ******************************************************************************/
+void cm_fpregs_context_save(uint32_t security_state)
+{
+#if !CTX_LAZY_FPREGS
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	fpregs_context_save(get_fpregs_ctx(ctx));
+#endif
+}
+
+void cm_fpregs_context_restore(uint32_t security_state)
+{
+#if !CTX_LAZY_FPREGS
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+#endif
+}
+#endif /* CTX_INCLUDE_FPREGS */
+
+#if CTX_LAZY_FPREGS && IMAGE_BL31
+/*******************************************************************************
+ * This function is called from the synchronous exception vector when the lower
+ * EL of the context 'ctx' accesses the FP registers while CPTR_EL3.TFP is set,
+ * i.e. while another context owns them. It saves the live registers to their
+ * owner, loads the registers of 'ctx' and makes it the owner. The faulting
+ * instruction is executed again on return.
+ ******************************************************************************/
+void cm_fpregs_lazy_switch(cpu_context_t *ctx)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	cpu_context_t *owner = fpregs_owner[cpu_idx];
+
+	assert(ctx != NULL);
+
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	if (owner == ctx)
+		return;
+
+	if (owner != NULL)
+		fpregs_context_save(get_fpregs_ctx(owner));
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+	fpregs_owner[cpu_idx] = ctx;
+}
+
+/*******************************************************************************
+ * This function saves the live FP registers of this CPU to their owner before
+ * the CPU loses them, e.g. when it is powered down. FP accesses from lower ELs
+ * trap again afterwards, so that the next one reloads its context.
+ ******************************************************************************/
+void cm_fpregs_lazy_flush(void)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	cpu_context_t *owner = fpregs_owner[cpu_idx];
+
+	if (owner == NULL)
+		return;
+
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	fpregs_context_save(get_fpregs_ctx(owner));
+	fpregs_owner[cpu_idx] = NULL;
+
+	write_cptr_el3(read_cptr_el3() | TFP_BIT);
+	isb();
+}
+#endif /* CTX_LAZY_FPREGS && IMAGE_BL31 */
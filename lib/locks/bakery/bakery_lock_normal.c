@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <arch_helpers.h>
@@ -32,6 +33,14 @@
  *
  * Note that the ARM architecture guarantees single-copy atomicity for aligned
  * accesses regardless of status of address translation.
+ *
+ * With USE_QUEUED_BAKERY_LOCKS, only the CPUs that have their data cache
+ * disabled go through the bakery. The others are coherent, so they can use
+ * exclusive accesses to join a queue (a CLH lock) where each CPU waits on the
+ * node of the CPU before it. That costs the same whatever the number of CPUs,
+ * where the bakery reads the lock data of every CPU twice. The CPU at the head
+ * of the queue and the CPU that won the bakery then take turns with a bakery of
+ * two, since either may hold the lock when a CPU powers down or warm boots.
  */
 
 #ifdef PLAT_PERCPU_BAKERY_LOCK_SIZE
@@ -56,6 +65,64 @@ IMPORT_SYM(uintptr_t, __PERCPU_BAKERY_LOCK_END__, BAKERY_LOCK_END);
 #define PERCPU_BAKERY_LOCK_SIZE (BAKERY_LOCK_END - BAKERY_LOCK_START)
 #endif
 
+#if USE_QUEUED_BAKERY_LOCKS
+/* Position of each side in the bakery of two */
+#define BAKERY_QUEUE_CACHED	0U
+#define BAKERY_QUEUE_UNCACHED	1U
+
+/*
+ * A node of a queue. It is set while its CPU waits for or holds the lock and
+ * the CPU after it in the queue waits for it to be cleared. Nodes move from CPU
+ * to CPU, so each has its own cache line.
+ */
+typedef struct bakery_queue_node {
+	volatile uint32_t waiting;
+} __aligned(CACHE_WRITEBACK_GRANULE) bakery_queue_node_t;
+
+/*
+ * The queue of a lock. Each cache line is written by one CPU at a time: the
+ * tail by the cached CPUs, through exclusive accesses only, the lock data of
+ * the cached side and the node that its holder released by the head of the
+ * queue, and the lock data of the uncached side by the CPU that won the bakery.
+ */
+typedef struct bakery_queue {
+	/* Last node of the queue, 0 for initial_node before any CPU joins */
+	volatile uintptr_t tail __aligned(CACHE_WRITEBACK_GRANULE);
+	volatile uint16_t cached_data __aligned(CACHE_WRITEBACK_GRANULE);
+	bakery_queue_node_t *volatile holder;
+	volatile uint16_t uncached_data __aligned(CACHE_WRITEBACK_GRANULE);
+	bakery_queue_node_t initial_node;
+} bakery_queue_t;
+
+CASSERT(sizeof(bakery_info_t) == BAKERY_INFO_SIZE,
+	assert_bakery_info_size_mismatch);
+CASSERT(sizeof(bakery_queue_t) == BAKERY_QUEUE_SIZE,
+	assert_bakery_queue_size_mismatch);
+
+/*
+ * A CPU joins a queue with its spare node and gets the node of the CPU before
+ * it as its new spare once it is at the head, so one node per CPU is enough
+ * however many locks it holds.
+ */
+typedef struct bakery_queue_cpu {
+	bakery_queue_node_t node;
+	bakery_queue_node_t *spare;
+} bakery_queue_cpu_t;
+
+static bakery_queue_cpu_t bakery_queue_cpus[PLATFORM_CORE_COUNT];
+
+#ifdef PLAT_PERCPU_BAKERY_LOCK_SIZE
+IMPORT_SYM(uintptr_t, __PERCPU_BAKERY_LOCK_START__, BAKERY_LOCK_START);
+#endif
+IMPORT_SYM(uintptr_t, __BAKERY_QUEUE_START__, BAKERY_QUEUE_START);
+
+static inline bakery_queue_t *get_bakery_queue(bakery_lock_t *lock)
+{
+	return (bakery_queue_t *)BAKERY_QUEUE_START +
+		(((uintptr_t)lock - BAKERY_LOCK_START) / sizeof(bakery_info_t));
+}
+#endif /* USE_QUEUED_BAKERY_LOCKS */
+
 static inline bakery_lock_t *get_bakery_info(unsigned int cpu_ix,
 					     bakery_lock_t *lock)
 {
@@ -159,6 +226,107 @@ static unsigned int bakery_get_ticket(bakery_lock_t *lock,
 	return my_ticket;
 }
 
+#if USE_QUEUED_BAKERY_LOCKS
+/*
+ * Take the lock from the other side in the bakery of two. Each side writes its
+ * own lock data, so the same rules apply as for the bakery of all the CPUs.
+ */
+static void bakery_pair_get(volatile uint16_t *my_data,
+			    volatile uint16_t *their_data, unsigned int me,
+			    bool is_cached)
+{
+	unsigned int my_ticket, their_ticket, their_bakery_data;
+
+	*my_data = make_bakery_data(CHOOSING_TICKET, 0U);
+	write_cache_op((uintptr_t)my_data, is_cached);
+
+	read_cache_op((uintptr_t)their_data, is_cached);
+	my_ticket = bakery_ticket_number(*their_data) + 1U;
+	*my_data = make_bakery_data(CHOSEN_TICKET, my_ticket);
+	write_cache_op((uintptr_t)my_data, is_cached);
+
+	/* Wait for the other side to get their ticket */
+	do {
+		read_cache_op((uintptr_t)their_data, is_cached);
+		their_bakery_data = *their_data;
+	} while (bakery_is_choosing(their_bakery_data));
+
+	their_ticket = bakery_ticket_number(their_bakery_data);
+	if ((their_ticket != 0U) &&
+	    (bakery_get_priority(their_ticket, 1U - me) <
+	     bakery_get_priority(my_ticket, me))) {
+		do {
+			wfe();
+			read_cache_op((uintptr_t)their_data, is_cached);
+		} while (their_ticket == bakery_ticket_number(*their_data));
+	}
+}
+
+static void bakery_pair_release(volatile uint16_t *my_data, bool is_cached)
+{
+	dmbst();
+	*my_data = 0U;
+	write_cache_op((uintptr_t)my_data, is_cached);
+}
+
+/* Acquire the lock as a cached CPU, which only involves its queue */
+static void bakery_queue_get(bakery_lock_t *lock, unsigned int me)
+{
+	bakery_queue_t *queue = get_bakery_queue(lock);
+	bakery_queue_cpu_t *cpu = &bakery_queue_cpus[me];
+	bakery_queue_node_t *node, *pred;
+
+	if (cpu->spare == NULL)
+		cpu->spare = &cpu->node;
+	node = cpu->spare;
+
+	node->waiting = 1U;
+	write_cache_op((uintptr_t)node, true);
+
+	pred = (bakery_queue_node_t *)bakery_queue_swap(&queue->tail,
+							(uintptr_t)node);
+	if (pred == NULL)
+		pred = &queue->initial_node;
+
+	/*
+	 * Wait for the CPU before us to release the lock. It may do so with its
+	 * cache disabled, so do not rely on coherency to see it.
+	 */
+	for (;;) {
+		read_cache_op((uintptr_t)pred, true);
+		if (pred->waiting == 0U)
+			break;
+		wfe();
+	}
+
+	/* Nobody else refers to that node any more */
+	cpu->spare = pred;
+
+	queue->holder = node;
+	bakery_pair_get(&queue->cached_data, &queue->uncached_data,
+			BAKERY_QUEUE_CACHED, true);
+
+	dmbld();
+}
+
+static void bakery_queue_release(bakery_lock_t *lock, bool is_cached)
+{
+	bakery_queue_t *queue = get_bakery_queue(lock);
+	bakery_queue_node_t *node;
+
+	read_cache_op((uintptr_t)&queue->cached_data, is_cached);
+	assert(bakery_ticket_number(queue->cached_data) != 0U);
+	node = queue->holder;
+
+	bakery_pair_release(&queue->cached_data, is_cached);
+
+	/* Hand the lock over to the next CPU in the queue */
+	node->waiting = 0U;
+	write_cache_op((uintptr_t)node, is_cached);
+	sev();
+}
+#endif /* USE_QUEUED_BAKERY_LOCKS */
+
 void bakery_lock_get(bakery_lock_t *lock)
 {
 	unsigned int they, me, is_cached;
@@ -173,6 +341,13 @@ void bakery_lock_get(bakery_lock_t *lock)
 	is_cached = read_sctlr_el3() & SCTLR_C_BIT;
 #endif
 
+#if USE_QUEUED_BAKERY_LOCKS
+	if (is_cached != 0U) {
+		bakery_queue_get(lock, me);
+		return;
+	}
+#endif
+
 	/* Get a ticket */
 	my_ticket = bakery_get_ticket(lock, me, is_cached);
 
@@ -218,6 +393,13 @@ void bakery_lock_get(bakery_lock_t *lock)
 		}
 	}
 
+#if USE_QUEUED_BAKERY_LOCKS
+	/* Now take turns with the head of the queue */
+	bakery_pair_get(&get_bakery_queue(lock)->uncached_data,
+			&get_bakery_queue(lock)->cached_data,
+			BAKERY_QUEUE_UNCACHED, is_cached);
+#endif
+
 	/*
 	 * Lock acquired. Ensure that any reads from a shared resource in the
 	 * critical section read values after the lock is acquired.
@@ -236,6 +418,16 @@ void bakery_lock_release(bakery_lock_t *lock)
 
 	my_bakery_info = get_bakery_info(plat_my_core_pos(), lock);
 
+#if USE_QUEUED_BAKERY_LOCKS
+	/* Locks acquired with the cache enabled leave no ticket in the bakery */
+	if (!is_lock_acquired(my_bakery_info, is_cached)) {
+		bakery_queue_release(lock, is_cached);
+		return;
+	}
+
+	bakery_pair_release(&get_bakery_queue(lock)->uncached_data, is_cached);
+#endif
+
 	assert(is_lock_acquired(my_bakery_info, is_cached));
 
 	/*
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/generic_delay_timer.h>
+#include <lib/boot_instr.h>
+#include <lib/pmf/pmf.h>
+#include <plat/common/platform.h>
+
+/*
+ * The boot-time records are kept by a PMF service in every boot stage. BL31
+ * also exposes them through the PMF SMC interface, so that the normal world
+ * can read them back using the MPIDR of the primary CPU.
+ */
+#ifdef IMAGE_BL31
+PMF_REGISTER_SERVICE_SMC(boot_instr_svc, PMF_BOOT_INSTR_SVC_ID,
+	BOOT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+#else
+PMF_REGISTER_SERVICE(boot_instr_svc, PMF_BOOT_INSTR_SVC_ID,
+	BOOT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+#endif
+
+/* First id of the record of the image being loaded, 0 if there is none */
+static unsigned int cur_image_base;
+
+/* Copy of the records handed over to the next stage */
+static unsigned long long export_records[BOOT_INSTR_TOTAL_IDS];
+
+static unsigned long long boot_instr_get(unsigned int tid)
+{
+	unsigned long long val;
+
+	PMF_GET_TIMESTAMP_BY_INDEX(boot_instr_svc, tid, plat_my_core_pos(),
+				   PMF_NO_CACHE_MAINT, val);
+
+	return val;
+}
+
+/* Return the duration held in 'tid' in microseconds */
+static unsigned int boot_instr_get_us(unsigned int tid)
+{
+	return generic_delay_timer_ticks_to_us(boot_instr_get(tid));
+}
+
+static void boot_instr_set(unsigned int tid, unsigned long long val)
+{
+	PMF_WRITE_TIMESTAMP(boot_instr_svc, tid, PMF_NO_CACHE_MAINT, val);
+}
+
+/* Record the current system counter value in 'tid' */
+void boot_instr_mark(unsigned int tid)
+{
+	assert(tid < BOOT_INSTR_IMAGE_BASE);
+
+	PMF_CAPTURE_TIMESTAMP(boot_instr_svc, tid, PMF_NO_CACHE_MAINT);
+}
+
+/* Add the time elapsed since 'start' to the duration held in 'tid' */
+void boot_instr_add(unsigned int tid, unsigned long long start)
+{
+	unsigned long long now = read_cntpct_el0();
+
+	assert(tid < BOOT_INSTR_TOTAL_IDS);
+
+	boot_instr_set(tid, boot_instr_get(tid) + (now - start));
+}
+
+/*
+ * Select the record that boot_instr_image_add() accounts to. The same record
+ * is used again if an image is loaded more than once. Images are not recorded
+ * once all the records are in use.
+ */
+void boot_instr_image_begin(unsigned int image_id)
+{
+	unsigned int base;
+	unsigned long long id;
+
+	cur_image_base = 0U;
+
+	for (base = BOOT_INSTR_IMAGE_BASE; base < BOOT_INSTR_TOTAL_IDS;
+	     base += BOOT_INSTR_IMAGE_FIELDS) {
+		id = boot_instr_get(base + BOOT_INSTR_IMAGE_ID);
+		if ((id == 0ULL) || (id == ((unsigned long long)image_id + 1U))) {
+			boot_instr_set(base + BOOT_INSTR_IMAGE_ID,
+				       (unsigned long long)image_id + 1U);
+			cur_image_base = base;
+			return;
+		}
+	}
+
+	VERBOSE("Boot time: no record left for image id=%u\n", image_id);
+}
+
+/* Add the time elapsed since 'start' to a field of the current image */
+void boot_instr_image_add(unsigned int field, unsigned long long start)
+{
+	assert(field < BOOT_INSTR_IMAGE_FIELDS);
+
+	if (cur_image_base != 0U)
+		boot_instr_add(cur_image_base + field, start);
+}
+
+/*
+ * Return a copy of the records of this stage to be handed over to the next
+ * one, which may read it with the data cache disabled.
+ */
+const unsigned long long *boot_instr_export(void)
+{
+	unsigned int tid;
+
+	for (tid = 0U; tid < BOOT_INSTR_TOTAL_IDS; tid++)
+		export_records[tid] = boot_instr_get(tid);
+
+	flush_dcache_range((uintptr_t)export_records, sizeof(export_records));
+
+	return export_records;
+}
+
+/*
+ * Merge the records handed over by the previous stage. Each stage has its own
+ * entry and step ids, and image records are only written by the stage that
+ * loads the image, so a record already written by this stage is kept. This
+ * must be called before this stage loads any image.
+ */
+void boot_instr_import(const unsigned long long *records)
+{
+	unsigned int tid;
+
+	if (records == NULL)
+		return;
+
+	for (tid = 0U; tid < BOOT_INSTR_TOTAL_IDS; tid++) {
+		if ((records[tid] != 0ULL) && (boot_instr_get(tid) == 0ULL))
+			boot_instr_set(tid, records[tid]);
+	}
+}
+
+/* Print the records gathered so far */
+void boot_instr_print_summary(void)
+{
+	static const char *const entry_names[] = {
+		[BOOT_INSTR_BL1_ENTRY] = "BL1 entry",
+		[BOOT_INSTR_BL2_ENTRY] = "BL2 entry",
+		[BOOT_INSTR_BL31_ENTRY] = "BL31 entry",
+		[BOOT_INSTR_BL31_EXIT] = "BL31 exit",
+	};
+	static const char *const stage_names[BOOT_INSTR_STAGES] = {
+		[BOOT_INSTR_STAGE_BL1] = "BL1",
+		[BOOT_INSTR_STAGE_BL2] = "BL2",
+		[BOOT_INSTR_STAGE_BL31] = "BL31",
+	};
+	static const char *const step_names[BOOT_INSTR_STEPS] = {
+		[BOOT_INSTR_STEP_CONSOLE] = "console init",
+		[BOOT_INSTR_STEP_DDR] = "DDR init",
+	};
+	unsigned long long val;
+	unsigned int tid, stage, step, base;
+
+	NOTICE("Boot time (us):\n");
+
+	for (tid = 0U; tid < ARRAY_SIZE(entry_names); tid++) {
+		val = boot_instr_get(tid);
+		if (val != 0ULL)
+			NOTICE("  %s: %u\n", entry_names[tid],
+			       generic_delay_timer_ticks_to_us(val));
+	}
+
+	for (stage = 0U; stage < BOOT_INSTR_STAGES; stage++) {
+		for (step = 0U; step < BOOT_INSTR_STEPS; step++) {
+			val = boot_instr_get(BOOT_INSTR_STEP_ID(stage, step));
+			if (val != 0ULL)
+				NOTICE("  %s %s: %u\n", stage_names[stage],
+				       step_names[step],
+				       generic_delay_timer_ticks_to_us(val));
+		}
+	}
+
+	for (base = BOOT_INSTR_IMAGE_BASE; base < BOOT_INSTR_TOTAL_IDS;
+	     base += BOOT_INSTR_IMAGE_FIELDS) {
+		val = boot_instr_get(base + BOOT_INSTR_IMAGE_ID);
+		if (val == 0ULL)
+			break;
+
+		NOTICE("  image id=%u: open %u read %u auth %u decompress %u"
+		       " overlap %u\n",
+		       (unsigned int)(val - 1U),
+		       boot_instr_get_us(base + BOOT_INSTR_IMAGE_OPEN),
+		       boot_instr_get_us(base + BOOT_INSTR_IMAGE_READ),
+		       boot_instr_get_us(base + BOOT_INSTR_IMAGE_AUTH),
+		       boot_instr_get_us(base + BOOT_INSTR_IMAGE_DECOMPRESS),
+		       boot_instr_get_us(base + BOOT_INSTR_IMAGE_OVERLAP));
+	}
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <context.h>
+#include <lib/cassert.h>
+#include <lib/el3_trace.h>
+#include <lib/pmf/pmf.h>
+#include <lib/smccc.h>
+#include <plat/common/platform.h>
+
+#if !defined(PLAT_EL3_TRACE_BASE) || !defined(PLAT_EL3_TRACE_SIZE) || \
+	!defined(PLAT_EL3_TRACE_RING_SIZE)
+#error "ENABLE_EL3_TRACE needs PLAT_EL3_TRACE_BASE, _SIZE and _RING_SIZE"
+#endif
+
+CASSERT(sizeof(el3_trace_ring_t) == EL3_TRACE_RING_HDR_SIZE,
+	assert_el3_trace_ring_t_size_mismatch);
+CASSERT(sizeof(el3_trace_event_t) == EL3_TRACE_EVENT_SIZE,
+	assert_el3_trace_event_t_size_mismatch);
+CASSERT((PLAT_EL3_TRACE_RING_SIZE & (PLAT_EL3_TRACE_RING_SIZE - 1U)) == 0U,
+	assert_el3_trace_ring_size_not_power_of_two);
+CASSERT((PLATFORM_CORE_COUNT *
+	 EL3_TRACE_RING_STRIDE(PLAT_EL3_TRACE_RING_SIZE)) <=
+	PLAT_EL3_TRACE_SIZE, assert_el3_trace_region_too_small);
+
+static unsigned long long el3_trace_get_ts(unsigned int tid,
+					   u_register_t mpidr,
+					   unsigned int flags);
+
+PMF_REGISTER_SERVICE_SMC_OWN(el3_trace_svc, PMF_ARM_TIF_IMPL_ID,
+	PMF_EL3_TRACE_SVC_ID, EL3_TRACE_TOTAL_IDS, NULL, el3_trace_get_ts)
+
+/* Set once the rings are initialised, events are dropped until then */
+static bool el3_trace_ready;
+
+static el3_trace_ring_t *get_ring(unsigned int core_pos)
+{
+	return (el3_trace_ring_t *)(PLAT_EL3_TRACE_BASE + (core_pos *
+			EL3_TRACE_RING_STRIDE(PLAT_EL3_TRACE_RING_SIZE)));
+}
+
+/* Initialise the rings of all CPUs, on the primary CPU during cold boot */
+void el3_trace_init(void)
+{
+	el3_trace_ring_t *ring;
+	unsigned int i;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		ring = get_ring(i);
+		ring->magic = EL3_TRACE_RING_MAGIC;
+		ring->size = PLAT_EL3_TRACE_RING_SIZE;
+		ring->head = 0U;
+		ring->freq = read_cntfrq_el0();
+		ring->reserved = 0U;
+	}
+
+	el3_trace_ready = true;
+}
+
+/*
+ * Record an event in the ring of this CPU. The CPU is the only writer of its
+ * ring, and interrupts are masked so that a handler can't record an event in
+ * the middle of this one. A reader on another CPU sees the seq field of the
+ * event change from 0 to its final value once the other fields are written.
+ */
+void el3_trace_event(unsigned int id, u_register_t arg0, u_register_t arg1)
+{
+	el3_trace_ring_t *ring;
+	el3_trace_event_t *event;
+	u_register_t daif;
+	uint64_t head;
+
+	if (!el3_trace_ready)
+		return;
+
+	daif = read_daif();
+	write_daifset(DAIF_IRQ_BIT | DAIF_FIQ_BIT);
+
+	ring = get_ring(plat_my_core_pos());
+	head = ring->head;
+	event = &ring->events[head & (PLAT_EL3_TRACE_RING_SIZE - 1U)];
+
+	event->seq = 0U;
+	dmbish();
+
+	event->id = id;
+	event->timestamp = read_cntpct_el0();
+	event->arg0 = arg0;
+	event->arg1 = arg1;
+
+	/* Publish the event, then the new head */
+	dmbish();
+	event->seq = (uint32_t)head + 1U;
+	ring->head = head + 1U;
+
+	write_daif(daif);
+}
+
+/*
+ * The trace region can be read by the normal world, so nothing that belongs
+ * to the secure world is recorded: the function id and arguments of SMCs from
+ * the secure world, and the values returned to it, are replaced by 0.
+ */
+static bool is_secure_ctx(void *handle)
+{
+	u_register_t scr;
+
+	scr = read_ctx_reg(get_el3state_ctx(handle), CTX_SCR_EL3);
+
+	return (scr & SCR_NS_BIT) == 0U;
+}
+
+/* Called by the SMC handler before the runtime service handler */
+void el3_trace_smc_entry(uint32_t smc_fid, u_register_t x1, u_register_t flags)
+{
+	if (is_caller_secure(flags)) {
+		smc_fid = 0U;
+		x1 = 0U;
+	}
+
+	el3_trace_event(EL3_TRACE_SMC_ENTRY, smc_fid, x1);
+}
+
+/* Called by the SMC handler with the context returned by the service */
+void el3_trace_smc_exit(uint32_t smc_fid, void *handle, u_register_t flags)
+{
+	u_register_t x0 = 0U;
+
+	if (is_caller_secure(flags))
+		smc_fid = 0U;
+	else if ((handle != NULL) && !is_secure_ctx(handle))
+		x0 = read_ctx_reg(get_gpregs_ctx(handle), CTX_GPREG_X0);
+
+	el3_trace_event(EL3_TRACE_SMC_EXIT, smc_fid, x0);
+}
+
+static unsigned long long el3_trace_get_ts(unsigned int tid,
+					   u_register_t mpidr,
+					   unsigned int flags)
+{
+	int core_pos;
+
+	switch (tid & PMF_TID_MASK) {
+	case EL3_TRACE_TID_BASE:
+		return PLAT_EL3_TRACE_BASE;
+	case EL3_TRACE_TID_RING_SIZE:
+		return PLAT_EL3_TRACE_RING_SIZE;
+	case EL3_TRACE_TID_HEAD:
+		/* The MPIDR comes from the SMC caller */
+		core_pos = plat_core_pos_by_mpidr(mpidr);
+		if (core_pos < 0)
+			return 0ULL;
+		return get_ring((unsigned int)core_pos)->head;
+	default:
+		return 0ULL;
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,6 +13,7 @@
 #include <common/debug.h>
 #include <context.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
@@ -815,6 +816,12 @@ void psci_warmboot_entrypoint(void)
 	else
 		psci_cpu_suspend_finish(cpu_idx, &state_info);
 
+	/*
+	 * Record the event only now: before the finish handlers, the data cache
+	 * may still be disabled.
+	 */
+	el3_trace_event(EL3_TRACE_PSCI_WAKEUP, end_pwrlvl, 1U);
+
 	/*
 	 * Set the requested and target state of this CPU and all the higher
 	 * power domains which are ancestors of this CPU to run.
@@ -950,6 +957,11 @@ int psci_secondaries_brought_up(void)
  ******************************************************************************/
 void psci_do_pwrdown_sequence(unsigned int power_level)
 {
+#if CTX_LAZY_FPREGS
+	/* The live FP registers are lost when the CPU powers down */
+	cm_fpregs_lazy_flush();
+#endif
+
 #if HW_ASSISTED_COHERENCY
 	/*
 	 * With hardware-assisted coherency, the CPU drivers only initiate the
@@ -28,6 +28,9 @@ ifeq (${USE_COHERENT_MEM}, 1)
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_coherent.c
 else
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
+ifeq (${USE_QUEUED_BAKERY_LOCKS}, 1)
+PSCI_LIB_SOURCES		+=	lib/locks/bakery/${ARCH}/bakery_queue.S
+endif
 endif
 
 ifeq (${ENABLE_PSCI_STAT}, 1)
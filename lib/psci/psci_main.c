@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,6 +10,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <lib/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <lib/smccc.h>
@@ -105,8 +106,12 @@ int psci_cpu_suspend(unsigned int power_state,
 		    PMF_NO_CACHE_MAINT);
 #endif
 
+		el3_trace_event(EL3_TRACE_PSCI_SUSPEND, PSCI_CPU_PWR_LVL, 0U);
+
 		psci_plat_pm_ops->cpu_standby(cpu_pd_state);
 
+		el3_trace_event(EL3_TRACE_PSCI_WAKEUP, PSCI_CPU_PWR_LVL, 0U);
+
 		/* Upon exit from standby, set the state back to RUN. */
 		psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,6 +15,7 @@
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -199,6 +200,10 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	psci_stats_update_pwr_down(end_pwrlvl, state_info);
 #endif
 
+	/* Record the event while the data cache is still enabled */
+	el3_trace_event(EL3_TRACE_PSCI_SUSPEND, end_pwrlvl,
+			is_power_down_state);
+
 	if (is_power_down_state != 0U)
 		psci_suspend_to_pwrdown_start(end_pwrlvl, ep, state_info);
 
@@ -264,6 +269,8 @@ exit:
 	    PMF_NO_CACHE_MAINT);
 #endif
 
+	el3_trace_event(EL3_TRACE_PSCI_WAKEUP, end_pwrlvl, 0U);
+
 	/*
 	 * After we wake up from context retaining suspend, call the
 	 * context retaining suspend finisher.
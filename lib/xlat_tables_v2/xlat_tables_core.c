@@ -654,6 +654,114 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	return table_idx_va - 1U;
 }
 
+#if XLAT_TABLES_CONT_HINT
+
+/*
+ * Returns true if the XLAT_CONT_ENTRIES block or page descriptors starting at
+ * 'desc' can be marked as a contiguous run: they map consecutive blocks of
+ * memory with the same attributes, starting at an address aligned to the size
+ * of the whole run.
+ */
+static bool xlat_desc_run_is_contiguous(const uint64_t *desc,
+					unsigned int level)
+{
+	uint64_t first = desc[0];
+	uint64_t run_size = (uint64_t)XLAT_BLOCK_SIZE(level) * XLAT_CONT_ENTRIES;
+	uint64_t desc_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+
+	if ((first & DESC_MASK) != desc_type)
+		return false;
+
+	if (((first & TABLE_ADDR_MASK) & (run_size - 1U)) != 0U)
+		return false;
+
+	/*
+	 * The output address is the only field that differs between the
+	 * descriptors of a run, and it doesn't carry over the run.
+	 */
+	for (unsigned int i = 1U; i < XLAT_CONT_ENTRIES; i++) {
+		if (desc[i] != (first + (i * (uint64_t)XLAT_BLOCK_SIZE(level))))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns true if the specified VA range overlaps a dynamic region. These can
+ * be unmapped later, which a contiguous run must not span.
+ */
+static bool xlat_range_is_dynamic(const xlat_ctx_t *ctx, uintptr_t base_va,
+				  size_t size)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	uintptr_t end_va = base_va + size - 1U;
+
+	for (const mmap_region_t *mm = ctx->mmap; mm->size != 0U; ++mm) {
+		if (((mm->attr & MT_DYNAMIC) != 0U) &&
+		    (mm->base_va <= end_va) &&
+		    ((mm->base_va + mm->size - 1U) >= base_va))
+			return true;
+	}
+#endif
+	return false;
+}
+
+/*
+ * Recursive function that sets the contiguous hint in all the runs of block
+ * and page descriptors that allow it, once all the regions are mapped. This
+ * lets regions that are next to each other share TLB entries too.
+ */
+static void xlat_tables_set_contiguous(xlat_ctx_t *ctx,
+				       const uintptr_t table_base_va,
+				       uint64_t *const table_base,
+				       const unsigned int table_entries,
+				       const unsigned int level)
+{
+	unsigned int table_idx = 0U;
+
+	while (table_idx < table_entries) {
+		uintptr_t table_idx_va = table_base_va +
+				(table_idx * XLAT_BLOCK_SIZE(level));
+		uint64_t desc = table_base[table_idx];
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			uint64_t *subtable =
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK);
+
+			xlat_tables_set_contiguous(ctx, table_idx_va, subtable,
+						   XLAT_TABLE_ENTRIES,
+						   level + 1U);
+			table_idx++;
+			continue;
+		}
+
+		if ((level >= MIN_LVL_BLOCK_DESC) &&
+		    ((table_idx % XLAT_CONT_ENTRIES) == 0U) &&
+		    ((table_idx + XLAT_CONT_ENTRIES) <= table_entries) &&
+		    xlat_desc_run_is_contiguous(&table_base[table_idx], level) &&
+		    !xlat_range_is_dynamic(ctx, table_idx_va,
+				XLAT_BLOCK_SIZE(level) * XLAT_CONT_ENTRIES)) {
+			for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++)
+				table_base[table_idx + i] |=
+					UPPER_ATTRS(CONT_HINT);
+
+			table_idx += XLAT_CONT_ENTRIES;
+		} else {
+			table_idx++;
+		}
+	}
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)table_base,
+				table_entries * sizeof(uint64_t));
+#endif
+}
+
+#endif /* XLAT_TABLES_CONT_HINT */
+
 /*
  * Function that verifies that a region can be mapped.
  * Returns:
@@ -1221,6 +1329,11 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 		mm++;
 	}
 
+#if XLAT_TABLES_CONT_HINT
+	xlat_tables_set_contiguous(ctx, 0U, ctx->base_table,
+				   ctx->base_table_entries, ctx->base_level);
+#endif
+
 	assert(ctx->pa_max_address <= xlat_arch_get_max_supported_pa());
 	assert(ctx->max_va <= ctx->va_max_address);
 	assert(ctx->max_pa <= ctx->pa_max_address);
@@ -59,9 +59,16 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
  */
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
+/*
+ * Invalidate all TLB entries of the given translation regime, in the same Inner
+ * Shareable domain. Cheaper than xlat_arch_tlbi_va() for each page when many
+ * translation table entries are modified at once.
+ */
+void xlat_arch_tlbi_all(int xlat_regime);
+
 /*
  * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * xlat_arch_tlbi_va() or xlat_arch_tlbi_all().
  */
 void xlat_arch_tlbi_va_sync(void);
 
@@ -34,17 +34,75 @@ void xlat_tables_print(__unused xlat_ctx_t *ctx)
 
 #else /* if LOG_LEVEL >= LOG_LEVEL_VERBOSE */
 
+/*
+ * Return the number of TLB entries needed to map the specified region on its
+ * own, i.e. the number of blocks and pages that the alignment of its addresses
+ * and its granularity allow, with each contiguous run counted once if 'cont' is
+ * true. Neighbouring regions that share blocks or runs aren't considered.
+ */
+static unsigned long long xlat_mmap_tlb_entries(const mmap_region_t *mm,
+						bool cont)
+{
+	uintptr_t va = mm->base_va;
+	unsigned long long pa = mm->base_pa;
+	unsigned long long left = mm->size;
+	unsigned long long entries = 0ULL;
+
+	while (left > 0ULL) {
+		unsigned long long block_size = PAGE_SIZE;
+
+		for (unsigned int level = MIN_LVL_BLOCK_DESC;
+		     level < XLAT_TABLE_LEVEL_MAX; ++level) {
+			unsigned long long size = XLAT_BLOCK_SIZE(level);
+
+			if ((size <= mm->granularity) && (size <= left) &&
+			    (((va | pa) & (size - 1ULL)) == 0ULL)) {
+				block_size = size;
+				break;
+			}
+		}
+
+		if (cont) {
+			unsigned long long run_size =
+				block_size * XLAT_CONT_ENTRIES;
+
+			if ((run_size <= left) &&
+			    (((va | pa) & (run_size - 1ULL)) == 0ULL))
+				block_size = run_size;
+		}
+
+		va += block_size;
+		pa += block_size;
+		left -= block_size;
+		entries++;
+	}
+
+	return entries;
+}
+
 void xlat_mmap_print(const mmap_region_t *mmap)
 {
 	printf("mmap:\n");
 	const mmap_region_t *mm = mmap;
+	unsigned long long entries = 0ULL, cont_entries = 0ULL;
 
 	while (mm->size != 0U) {
+		unsigned long long region_entries =
+			xlat_mmap_tlb_entries(mm, false);
+		unsigned long long region_cont_entries =
+			xlat_mmap_tlb_entries(mm, true);
+
 		printf(" VA:0x%lx  PA:0x%llx  size:0x%zx  attr:0x%x  granularity:0x%zx\n",
 		       mm->base_va, mm->base_pa, mm->size, mm->attr,
 		       mm->granularity);
+		printf("   TLB entries: %llu, %llu with contiguous hint\n",
+		       region_entries, region_cont_entries);
+		entries += region_entries;
+		cont_entries += region_cont_entries;
 		++mm;
 	};
+	printf(" TLB entries: %llu, %llu with contiguous hint\n", entries,
+	       cont_entries);
 	printf("\n");
 }
 
@@ -103,6 +161,10 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 		printf("-GP");
 	}
 #endif
+
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+		printf("-CONT");
+	}
 }
 
 static const char * const level_spacers[] = {
@@ -325,9 +387,55 @@ static uint64_t *find_xlat_table_entry(uintptr_t virtual_addr,
 }
 
 
+/*
+ * Return the attributes of the memory mapped by the block or page descriptor
+ * 'desc'.
+ */
+static uint32_t xlat_desc_get_attributes(const xlat_ctx_t *ctx, uint64_t desc)
+{
+	uint32_t attributes = 0U;
+
+	uint64_t attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+
+	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
+		attributes |= MT_MEMORY;
+	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
+		attributes |= MT_NON_CACHEABLE;
+	} else {
+		assert(attr_index == ATTR_DEVICE_INDEX);
+		attributes |= MT_DEVICE;
+	}
+
+	uint64_t ap2_bit = (desc >> AP2_SHIFT) & 1U;
+
+	if (ap2_bit == AP2_RW)
+		attributes |= MT_RW;
+
+	if (ctx->xlat_regime == EL1_EL0_REGIME) {
+		uint64_t ap1_bit = (desc >> AP1_SHIFT) & 1U;
+
+		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
+			attributes |= MT_USER;
+	}
+
+	uint64_t ns_bit = (desc >> NS_SHIFT) & 1U;
+
+	if (ns_bit == 1U)
+		attributes |= MT_NS;
+
+	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
+
+	if ((desc & xn_mask) == xn_mask) {
+		attributes |= MT_EXECUTE_NEVER;
+	} else {
+		assert((desc & xn_mask) == 0U);
+	}
+
+	return attributes;
+}
+
 static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
-		uintptr_t base_va, uint32_t *attributes, uint64_t **table_entry,
-		unsigned long long *addr_pa, unsigned int *table_level)
+		uintptr_t base_va, uint32_t *attributes)
 {
 	uint64_t *entry;
 	uint64_t desc;
@@ -356,18 +464,6 @@ static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
 		return -EINVAL;
 	}
 
-	if (addr_pa != NULL) {
-		*addr_pa = *entry & TABLE_ADDR_MASK;
-	}
-
-	if (table_entry != NULL) {
-		*table_entry = entry;
-	}
-
-	if (table_level != NULL) {
-		*table_level = level;
-	}
-
 	desc = *entry;
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
@@ -377,68 +473,153 @@ static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
 
 	assert(attributes != NULL);
-	*attributes = 0U;
+	*attributes = xlat_desc_get_attributes(ctx, desc);
 
-	uint64_t attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+	return 0;
+}
 
-	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
-		*attributes |= MT_MEMORY;
-	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
-		*attributes |= MT_NON_CACHEABLE;
-	} else {
-		assert(attr_index == ATTR_DEVICE_INDEX);
-		*attributes |= MT_DEVICE;
-	}
 
-	uint64_t ap2_bit = (desc >> AP2_SHIFT) & 1U;
+int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
+				uint32_t *attr)
+{
+	return xlat_get_mem_attributes_internal(ctx, base_va, attr);
+}
 
-	if (ap2_bit == AP2_RW)
-		*attributes |= MT_RW;
 
-	if (ctx->xlat_regime == EL1_EL0_REGIME) {
-		uint64_t ap1_bit = (desc >> AP1_SHIFT) & 1U;
+/*
+ * Above this number of pages to change, invalidate all the TLB entries of the
+ * translation regime rather than each page.
+ */
+#define XLAT_CHANGE_TLBI_VA_MAX		U(64)
 
-		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
-			*attributes |= MT_USER;
+/*
+ * Return the translation table of the last lookup level that holds the entry
+ * of 'virtual_addr', and its number of entries in 'out_entries'. Return NULL if
+ * 'virtual_addr' isn't mapped at the granularity of a page.
+ */
+static uint64_t *find_xlat_page_table(const xlat_ctx_t *ctx,
+				      uintptr_t virtual_addr,
+				      unsigned int *out_entries)
+{
+	uint64_t *table = ctx->base_table;
+	unsigned int entries = ctx->base_table_entries;
+
+	for (unsigned int level = ctx->base_level;
+	     level < XLAT_TABLE_LEVEL_MAX;
+	     ++level) {
+		uint64_t idx, desc;
+
+		idx = XLAT_TABLE_IDX(virtual_addr, level);
+		if (idx >= entries) {
+			WARN("Missing xlat table entry at address 0x%lx\n",
+			     virtual_addr);
+			return NULL;
+		}
+
+		desc = table[idx];
+
+		if ((desc & DESC_MASK) == BLOCK_DESC) {
+			WARN("Address 0x%lx is not mapped at the right granularity.\n",
+			     virtual_addr);
+			WARN("Granularity is 0x%llx, should be 0x%x.\n",
+			     (unsigned long long)XLAT_BLOCK_SIZE(level), PAGE_SIZE);
+			return NULL;
+		}
+
+		if ((desc & DESC_MASK) != TABLE_DESC) {
+			WARN("Address 0x%lx is not mapped.\n", virtual_addr);
+			return NULL;
+		}
+
+		table = (uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK);
+		entries = XLAT_TABLE_ENTRIES;
 	}
 
-	uint64_t ns_bit = (desc >> NS_SHIFT) & 1U;
+	*out_entries = entries;
 
-	if (ns_bit == 1U)
-		*attributes |= MT_NS;
+	return table;
+}
 
-	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
+/*
+ * Return the page entry of 'virtual_addr' and in 'count' how many of the
+ * following 'pages_count' pages have their entry in the same table, so that
+ * a range is walked once per table rather than once per page.
+ */
+static uint64_t *find_xlat_page_entries(const xlat_ctx_t *ctx,
+					uintptr_t virtual_addr,
+					size_t pages_count, size_t *count)
+{
+	uint64_t *table;
+	unsigned int entries, idx;
 
-	if ((desc & xn_mask) == xn_mask) {
-		*attributes |= MT_EXECUTE_NEVER;
-	} else {
-		assert((desc & xn_mask) == 0U);
+	table = find_xlat_page_table(ctx, virtual_addr, &entries);
+	if (table == NULL) {
+		return NULL;
 	}
 
-	return 0;
+	idx = (unsigned int)XLAT_TABLE_IDX(virtual_addr, XLAT_TABLE_LEVEL_MAX);
+	if (idx >= entries) {
+		WARN("Missing xlat table entry at address 0x%lx\n",
+		     virtual_addr);
+		return NULL;
+	}
+
+	*count = MIN((size_t)(entries - idx), pages_count);
+
+	return &table[idx];
 }
 
+/* Size of the memory mapped by a contiguous run of page descriptors */
+#define XLAT_CONT_PAGES_SIZE	(XLAT_CONT_ENTRIES * PAGE_SIZE)
 
-int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
-				uint32_t *attr)
+/*
+ * Return the descriptor that replaces the page descriptor 'desc' of
+ * 'virtual_addr' when changing the attributes of the region of 'size' bytes at
+ * 'base_va' to 'attr'. From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER
+ * and MT_USER/MT_PRIVILEGED are taken into account. Any other information is
+ * ignored.
+ *
+ * All the descriptors of a contiguous run must have the same attributes, so
+ * the contiguous hint is only kept by runs that are entirely in the region. It
+ * is cleared from the pages outside of the region that share a run with it.
+ */
+static uint64_t xlat_change_page_desc(const xlat_ctx_t *ctx, uint64_t desc,
+				      uintptr_t virtual_addr, uintptr_t base_va,
+				      size_t size, uint32_t attr)
 {
-	return xlat_get_mem_attributes_internal(ctx, base_va, attr,
-				NULL, NULL, NULL);
-}
+	uintptr_t run_va = virtual_addr & ~(uintptr_t)(XLAT_CONT_PAGES_SIZE - 1U);
+	uint64_t cont = desc & UPPER_ATTRS(CONT_HINT);
+	uint32_t new_attr;
 
+	if ((virtual_addr < base_va) || ((virtual_addr - base_va) >= size)) {
+		return desc & ~cont;
+	}
 
-int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
-				   size_t size, uint32_t attr)
+	if ((run_va < base_va) ||
+	    (((run_va - base_va) + XLAT_CONT_PAGES_SIZE) > size)) {
+		cont = 0U;
+	}
+
+	new_attr = xlat_desc_get_attributes(ctx, desc);
+	new_attr &= ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+	new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+	return xlat_desc(ctx, new_attr, desc & TABLE_ADDR_MASK,
+			 XLAT_TABLE_LEVEL_MAX) | cont;
+}
+
+int xlat_change_mem_attributes_range_ctx(const xlat_ctx_t *ctx,
+		uintptr_t base_va, size_t size, uint32_t attr, size_t *changed)
 {
-	/* Note: This implementation isn't optimized. */
+	uintptr_t va, run_base_va, run_end_va;
+	size_t pages_count, pages, count;
+	size_t broken_count = 0U, changed_count = 0U;
+	uint64_t *entry;
+	uint64_t desc;
 
 	assert(ctx != NULL);
 	assert(ctx->initialized);
 
-	unsigned long long virt_addr_space_size =
-		(unsigned long long)ctx->va_max_address + 1U;
-	assert(virt_addr_space_size > 0U);
-
 	if (!IS_PAGE_ALIGNED(base_va)) {
 		WARN("%s: Address 0x%lx is not aligned on a page boundary.\n",
 		     __func__, base_va);
@@ -462,110 +643,144 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		return -EINVAL;
 	}
 
-	size_t pages_count = size / PAGE_SIZE;
+	pages_count = size / PAGE_SIZE;
 
 	VERBOSE("Changing memory attributes of %zu pages starting from address 0x%lx...\n",
 		pages_count, base_va);
 
-	uintptr_t base_va_original = base_va;
-
 	/*
 	 * Sanity checks.
 	 */
-	for (size_t i = 0U; i < pages_count; ++i) {
-		const uint64_t *entry;
-		uint64_t desc, attr_index;
-		unsigned int level;
-
-		entry = find_xlat_table_entry(base_va,
-					      ctx->base_table,
-					      ctx->base_table_entries,
-					      virt_addr_space_size,
-					      &level);
+	for (va = base_va, pages = pages_count; pages > 0U;
+	     va += count * PAGE_SIZE, pages -= count) {
+		entry = find_xlat_page_entries(ctx, va, pages, &count);
 		if (entry == NULL) {
-			WARN("Address 0x%lx is not mapped.\n", base_va);
 			return -EINVAL;
 		}
 
-		desc = *entry;
+		for (size_t i = 0U; i < count; i++) {
+			uint64_t attr_index;
 
-		/*
-		 * Check that all the required pages are mapped at page
-		 * granularity.
-		 */
-		if (((desc & DESC_MASK) != PAGE_DESC) ||
-			(level != XLAT_TABLE_LEVEL_MAX)) {
-			WARN("Address 0x%lx is not mapped at the right granularity.\n",
-			     base_va);
-			WARN("Granularity is 0x%llx, should be 0x%x.\n",
-			     (unsigned long long)XLAT_BLOCK_SIZE(level), PAGE_SIZE);
-			return -EINVAL;
-		}
+			desc = entry[i];
+			if ((desc & DESC_MASK) != PAGE_DESC) {
+				WARN("Address 0x%lx is not mapped.\n",
+				     va + (i * PAGE_SIZE));
+				return -EINVAL;
+			}
 
-		/*
-		 * If the region type is device, it shouldn't be executable.
-		 */
-		attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
-		if (attr_index == ATTR_DEVICE_INDEX) {
-			if ((attr & MT_EXECUTE_NEVER) == 0U) {
+			/*
+			 * If the region type is device, it shouldn't be
+			 * executable.
+			 */
+			attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+			if ((attr_index == ATTR_DEVICE_INDEX) &&
+			    ((attr & MT_EXECUTE_NEVER) == 0U)) {
 				WARN("Setting device memory as executable at address 0x%lx.",
-				     base_va);
+				     va + (i * PAGE_SIZE));
 				return -EINVAL;
 			}
 		}
+	}
+
+	/*
+	 * Extend the pages to update to the whole contiguous runs that the
+	 * first and last pages are part of. These runs are in the same tables
+	 * as the pages, and all their descriptors are valid.
+	 */
+	run_base_va = base_va;
+	entry = find_xlat_page_entries(ctx, base_va, 1U, &count);
+	assert(entry != NULL);
+	if ((*entry & UPPER_ATTRS(CONT_HINT)) != 0U) {
+		run_base_va &= ~(uintptr_t)(XLAT_CONT_PAGES_SIZE - 1U);
+	}
 
-		base_va += PAGE_SIZE;
+	run_end_va = base_va + size - PAGE_SIZE;
+	entry = find_xlat_page_entries(ctx, run_end_va, 1U, &count);
+	assert(entry != NULL);
+	if ((*entry & UPPER_ATTRS(CONT_HINT)) != 0U) {
+		run_end_va |= XLAT_CONT_PAGES_SIZE - 1U;
+	} else {
+		run_end_va += PAGE_SIZE - 1U;
 	}
 
-	/* Restore original value. */
-	base_va = base_va_original;
+	pages_count = ((run_end_va - run_base_va) / PAGE_SIZE) + 1U;
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	/*
+	 * The break-before-make sequence requires writing an invalid
+	 * descriptor and making sure that the system sees the change before
+	 * writing the new descriptor. Break all the descriptors that change
+	 * first, so that one TLB invalidation and synchronization covers all of
+	 * them.
+	 *
+	 * Only the valid bit of each descriptor is cleared. The rest of an
+	 * invalid descriptor is ignored by the hardware, so the new descriptor
+	 * can be built from it afterwards.
+	 */
+	for (va = run_base_va, pages = pages_count; pages > 0U;
+	     va += count * PAGE_SIZE, pages -= count) {
+		entry = find_xlat_page_entries(ctx, va, pages, &count);
+		assert(entry != NULL);
+
+		for (size_t i = 0U; i < count; i++) {
+			desc = entry[i];
+			if (xlat_change_page_desc(ctx, desc, va + (i * PAGE_SIZE),
+					base_va, size, attr) == desc) {
+				continue;
+			}
+
+			entry[i] = desc & ~DESC_VALID_BIT;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+			dccvac((uintptr_t)&entry[i]);
+#endif
+			broken_count++;
+			if (((va + (i * PAGE_SIZE)) >= base_va) &&
+			    ((va + (i * PAGE_SIZE) - base_va) < size)) {
+				changed_count++;
+			}
 
-		uint32_t old_attr = 0U, new_attr;
-		uint64_t *entry = NULL;
-		unsigned int level = 0U;
-		unsigned long long addr_pa = 0ULL;
+			/* Invalidate any cached copy of this mapping. */
+			if (broken_count <= XLAT_CHANGE_TLBI_VA_MAX) {
+				xlat_arch_tlbi_va(va + (i * PAGE_SIZE),
+						  ctx->xlat_regime);
+			}
+		}
+	}
 
-		(void) xlat_get_mem_attributes_internal(ctx, base_va, &old_attr,
-					    &entry, &addr_pa, &level);
+	if (changed != NULL) {
+		*changed = changed_count;
+	}
 
-		/*
-		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
-		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
-		 * information is ignored.
-		 */
+	if (broken_count == 0U) {
+		return 0;
+	}
 
-		/* Clean the old attributes so that they can be rebuilt. */
-		new_attr = old_attr & ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+	if (broken_count > XLAT_CHANGE_TLBI_VA_MAX) {
+		xlat_arch_tlbi_all(ctx->xlat_regime);
+	}
 
-		/*
-		 * Update attributes, but filter out the ones this function
-		 * isn't allowed to change.
-		 */
-		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+	/* Ensure completion of the invalidation. */
+	xlat_arch_tlbi_va_sync();
 
-		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
-		 */
-		*entry = INVALID_DESC;
-#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
-#endif
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va(base_va, ctx->xlat_regime);
+	/* Write new descriptors */
+	for (va = run_base_va, pages = pages_count; pages > 0U;
+	     va += count * PAGE_SIZE, pages -= count) {
+		entry = find_xlat_page_entries(ctx, va, pages, &count);
+		assert(entry != NULL);
 
-		/* Ensure completion of the invalidation. */
-		xlat_arch_tlbi_va_sync();
+		for (size_t i = 0U; i < count; i++) {
+			desc = entry[i];
+			if ((desc & DESC_VALID_BIT) != 0U) {
+				continue;
+			}
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
+			entry[i] = xlat_change_page_desc(ctx,
+					desc | DESC_VALID_BIT,
+					va + (i * PAGE_SIZE), base_va, size,
+					attr);
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
+			dccvac((uintptr_t)&entry[i]);
 #endif
-		base_va += PAGE_SIZE;
+		}
 	}
 
 	/* Ensure that the last descriptor writen is seen by the system. */
@@ -573,3 +788,10 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 
 	return 0;
 }
+
+int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
+				   size_t size, uint32_t attr)
+{
+	return xlat_change_mem_attributes_range_ctx(ctx, base_va, size, attr,
+						    NULL);
+}
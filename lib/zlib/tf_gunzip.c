@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -100,3 +100,109 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 
 	return ret;
 }
+
+/*
+ * State of the decompression done with gunzip_stream_*(). 'gz_stream_ret' is the
+ * last value returned by inflate().
+ */
+static z_stream gz_stream;
+static int gz_stream_ret;
+
+/*
+ * gunzip_stream_start - start decompressing gzip data passed in pieces
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace, at least GUNZIP_STREAM_WORK_SIZE bytes
+ * @work_len: length of workspace
+ */
+int gunzip_stream_start(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+			size_t work_len)
+{
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	zeromem(&gz_stream, sizeof(gz_stream));
+	gz_stream.next_out = (typeof(gz_stream.next_out))out_buf;
+	gz_stream.avail_out = out_len;
+	gz_stream.zalloc = zcalloc;
+	gz_stream.zfree = zfree;
+	gz_stream.opaque = (voidpf)0;
+
+	zret = inflateInit(&gz_stream);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		gz_stream_ret = Z_STREAM_ERROR;
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	gz_stream_ret = Z_OK;
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next piece of gzip data
+ * @in_buf: compressed input, which may be reused once this returns
+ * @in_len: length of in_buf
+ *
+ * The sliding window is kept in the workspace, so that the input buffer does
+ * not need to hold more than one piece. Data after the end of the gzip
+ * stream is ignored.
+ */
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	if (gz_stream_ret == Z_STREAM_END)
+		return 0;
+
+	if (gz_stream_ret != Z_OK)
+		return -EIO;
+
+	gz_stream.next_in = (typeof(gz_stream.next_in))in_buf;
+	gz_stream.avail_in = in_len;
+
+	gz_stream_ret = inflate(&gz_stream, Z_NO_FLUSH);
+
+	/* Input is left over only if the output buffer is full */
+	if ((gz_stream_ret == Z_OK) && (gz_stream.avail_in != 0U))
+		gz_stream_ret = Z_BUF_ERROR;
+
+	if ((gz_stream_ret != Z_OK) && (gz_stream_ret != Z_STREAM_END)) {
+		if (gz_stream.msg)
+			ERROR("%s\n", gz_stream.msg);
+		ERROR("zlib: inflate failed (ret = %d)\n", gz_stream_ret);
+		return (gz_stream_ret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_finish - end the decompression started by gunzip_stream_start
+ * @out_buf: upon exit, the end of output
+ *
+ * Returns 0 if the whole gzip stream has been decompressed.
+ */
+int gunzip_stream_finish(uintptr_t *out_buf)
+{
+	int ret = 0;
+
+	if (gz_stream_ret != Z_STREAM_END) {
+		if (gz_stream_ret == Z_OK)
+			ERROR("zlib: truncated input\n");
+		ret = (gz_stream_ret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	VERBOSE("zlib: %lu byte input\n", gz_stream.total_in);
+	VERBOSE("zlib: %lu byte output\n", gz_stream.total_out);
+
+	*out_buf = (uintptr_t)gz_stream.next_out;
+
+	if (gz_stream_ret != Z_STREAM_ERROR)
+		inflateEnd(&gz_stream);
+	gz_stream_ret = Z_STREAM_ERROR;
+
+	return ret;
+}
@@ -59,6 +59,10 @@ CTX_INCLUDE_FPREGS		:= 0
 # world. It is not needed to use it in the Non-secure world.
 CTX_INCLUDE_PAUTH_REGS		:= 0
 
+# Switch the FP registers in the cpu context on the first FP access from a lower
+# EL instead of on every world switch. Requires CTX_INCLUDE_FPREGS.
+CTX_LAZY_FPREGS			:= 0
+
 # Debug build
 DEBUG				:= 0
 
@@ -72,6 +76,12 @@ DISABLE_BIN_GENERATION		:= 0
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Flag to enable boot-time instrumentation using PMF
+ENABLE_BOOT_INSTRUMENTATION	:= 0
+
+# Flag to enable the per-CPU EL3 event trace rings
+ENABLE_EL3_TRACE		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
@@ -136,6 +146,9 @@ HW_ASSISTED_COHERENCY		:= 0
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
+# Use images stored in memory-mapped devices in place instead of copying them
+LOAD_IMAGE_ZERO_COPY		:= 0
+
 # NS timer register save and restore
 NS_TIMER_SWITCH			:= 0
 
@@ -188,9 +201,17 @@ SPIN_ON_BL1_EXIT		:= 0
 # Flags to build TF with Trusted Boot support
 TRUSTED_BOARD_BOOT		:= 0
 
+# Use the AArch64 assembly versions of memcpy, memmove, memset and memcmp
+# instead of the generic C ones in lib/libc
+USE_ASM_MEMFUNCS		:= 0
+
 # Build option to choose whether Trusted Firmware uses Coherent memory or not.
 USE_COHERENT_MEM		:= 1
 
+# Build option to queue the contenders of bakery locks that have their data
+# cache enabled, instead of making them scan the tickets of all the CPUs
+USE_QUEUED_BAKERY_LOCKS		:= 0
+
 # Build option to choose whether Trusted Firmware uses library at ROM
 USE_ROMLIB			:= 0
 
@@ -206,6 +227,10 @@ V				:= 0
 # platforms).
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
 
+# Build option to set the contiguous hint in the translation tables built by
+# the translation tables library v2
+XLAT_TABLES_CONT_HINT		:= 0
+
 # Build option to enable/disable the Statistical Profiling Extensions
 ENABLE_SPE_FOR_LOWER_ELS	:= 1
 
@@ -16,6 +16,7 @@
 #include <lib/xlat_tables/xlat_mmu_helpers.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <drivers/generic_delay_timer.h>
+#include <plat/common/platform.h>
 
 #include "a600_private.h"
 
@@ -89,6 +90,22 @@ void bl2_platform_setup(void)
  ******************************************************************************/
 void bl2_el3_plat_arch_setup(void)
 {
+	/*
+	 * There is no BL1 to hand over a memory layout, so map the whole
+	 * Trusted SRAM. The FIP window and the DRAM the images are loaded to
+	 * come from plat_a600_mmap, so image loading and hashing run with the
+	 * data cache enabled.
+	 */
+	a600_setup_page_tables(BL_RAM_BASE, BL_RAM_SIZE,
+			       BL_CODE_BASE, BL_CODE_END,
+			       BL_RO_DATA_BASE, BL_RO_DATA_END
+#if USE_COHERENT_MEM
+			       , BL_COHERENT_RAM_BASE, BL_COHERENT_RAM_END
+#endif
+			      );
+
+	enable_mmu_el3(0);
+
 	/* Initialise the IO layer and register platform IO devices */
 	plat_a600_io_setup();
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,8 +10,11 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/bl_common.h>
+#include <common/debug.h>
 #include <drivers/arm/gicv2.h>
+#include <lib/boot_instr.h>
 #include <lib/xlat_tables/xlat_mmu_helpers.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <plat/common/platform.h>
@@ -81,6 +84,10 @@ void bl31_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 	assert(params_from_bl2->h.type == PARAM_BL_PARAMS);
 	assert(params_from_bl2->h.version >= VERSION_2);
 
+	/* Merge the boot-time records of BL2 into the ones of BL31 */
+	if (params_from_bl2->h.size >= sizeof(bl_params_t))
+		boot_instr_import(params_from_bl2->boot_instr);
+
 	bl_params_node_t *bl_params = params_from_bl2->head;
 
 	/*
@@ -146,21 +153,17 @@ void bl31_plat_arch_setup(void)
 }
 
 #ifdef A600_PRELOADED_DTB_BASE
+/* Number of memory reservations added by a600_dtb_add_mem_rsv() */
+#define A600_DTB_MEM_RSV_ADDED	(1 + A600_CONSOLE_LOG + ENABLE_EL3_TRACE)
+
 /*
- * Add information to the device tree (if any) about the reserved DRAM used by
- * the Trusted Firmware.
+ * Add information to the device tree about the reserved DRAM used by the
+ * Trusted Firmware.
  */
-static void a600_dtb_add_mem_rsv(void)
+static void a600_dtb_add_mem_rsv(void *dtb)
 {
 	int i, regions, rc;
 	uint64_t addr, size;
-	void *dtb = (void *)A600_PRELOADED_DTB_BASE;
-
-	INFO("a600: Checking DTB...\n");
-
-	/* Return if no device tree is detected */
-	if (fdt_check_header(dtb) != 0)
-		return;
 
 	regions = fdt_num_mem_rsv(dtb);
 
@@ -208,6 +211,61 @@ static void a600_dtb_add_mem_rsv(void)
 
 	INFO("a600: Reserved 0x%llx - 0x%llx in DTB\n", SEC_SRAM_BASE,
 	     SEC_SRAM_BASE + SEC_SRAM_SIZE);
+
+#if A600_CONSOLE_LOG
+	/* Keep the normal world from using the console log region */
+	rc = fdt_add_mem_rsv(dtb, PLAT_A600_CONSOLE_LOG_BASE,
+			     PLAT_A600_CONSOLE_LOG_SIZE);
+	if (rc != 0) {
+		WARN("a600: Can't add mem reserve region (%d)\n", rc);
+	}
+#endif
+
+#if ENABLE_EL3_TRACE
+	/* Keep the normal world from allocating the EL3 trace region */
+	rc = fdt_add_mem_rsv(dtb, PLAT_EL3_TRACE_BASE, PLAT_EL3_TRACE_SIZE);
+	if (rc != 0) {
+		WARN("a600: Can't add mem reserve region (%d)\n", rc);
+	}
+#endif
+}
+
+/*
+ * Fix up the device tree (if any) for the normal world. It only grows by the
+ * memory reservations added to it, within the mapped region, and is packed
+ * again at the end.
+ */
+static void a600_prepare_dtb(void)
+{
+	void *dtb = (void *)A600_PRELOADED_DTB_BASE;
+	size_t size;
+	int rc;
+
+	INFO("a600: Checking DTB...\n");
+
+	/* Return if no device tree is detected */
+	if (fdt_check_header(dtb) != 0)
+		return;
+
+	size = fdt_totalsize(dtb) +
+	       (A600_DTB_MEM_RSV_ADDED * sizeof(struct fdt_reserve_entry));
+	size = MIN(size, (size_t)PLAT_A600_DTB_MAX_SIZE);
+
+	rc = fdt_open_into(dtb, dtb, (int)size);
+	if (rc != 0) {
+		WARN("a600: Can't open DTB (%d)\n", rc);
+		return;
+	}
+
+	a600_dtb_add_mem_rsv(dtb);
+
+	rc = fdt_pack(dtb);
+	if (rc != 0) {
+		WARN("a600: Can't pack DTB (%d)\n", rc);
+	}
+
+	/* The normal world may read the device tree with its caches off */
+	clean_dcache_range((uintptr_t)dtb, fdt_totalsize(dtb));
 }
 #endif
 
@@ -215,7 +273,7 @@ void bl31_platform_setup(void)
 {
 #ifdef A600_PRELOADED_DTB_BASE
 	/* Only modify a DTB if we know where to look for it */
-	a600_dtb_add_mem_rsv();
+	a600_prepare_dtb();
 #endif
 
 	/* Configure the interrupt controller */
@@ -223,4 +281,8 @@ void bl31_platform_setup(void)
 	gicv2_distif_init();
 	gicv2_pcpu_distif_init();
 	gicv2_cpuif_enable();
+
+#if A600_CONSOLE_LOG
+	a600_console_log_init();
+#endif
 }
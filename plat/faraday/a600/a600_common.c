@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,9 +13,11 @@
 #include <common/debug.h>
 #include <bl31/interrupt_mgmt.h>
 #include <drivers/arm/tzc400.h>
+#include <drivers/buffered_console.h>
 #include <drivers/console.h>
-#include <drivers/delay_timer.h>
 #include <drivers/ti/uart/uart_16550.h>
+#include <lib/boot_instr.h>
+#include <lib/cassert.h>
 #include <lib/mmio.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
@@ -35,7 +37,8 @@
 					MT_DEVICE | MT_RW | MT_SECURE)
 
 #ifdef A600_PRELOADED_DTB_BASE
-#define MAP_NS_DTB	MAP_REGION_FLAT(A600_PRELOADED_DTB_BASE, 0x10000, \
+#define MAP_NS_DTB	MAP_REGION_FLAT(A600_PRELOADED_DTB_BASE,		\
+					PLAT_A600_DTB_MAX_SIZE,		\
 					MT_MEMORY | MT_RW | MT_NS)
 #endif
 
@@ -45,6 +48,21 @@
 #define MAP_BL32_MEM	MAP_REGION_FLAT(BL32_MEM_BASE, BL32_MEM_SIZE,	\
 					MT_MEMORY | MT_RW | MT_SECURE)
 
+#define MAP_SEC_DRAM1	MAP_REGION_FLAT(SEC_DRAM1_BASE, SEC_DRAM1_SIZE,	\
+					MT_MEMORY | MT_RW | MT_SECURE)
+
+#define MAP_CONSOLE_LOG	MAP_REGION_FLAT(PLAT_A600_CONSOLE_LOG_BASE,	\
+					PLAT_A600_CONSOLE_LOG_SIZE,	\
+					MT_MEMORY | MT_RW | MT_NS)
+
+#define MAP_EL3_TRACE	MAP_REGION_FLAT(PLAT_EL3_TRACE_BASE,		\
+					PLAT_EL3_TRACE_SIZE,		\
+					MT_MEMORY | MT_RW | MT_NS)
+
+#define MAP_FIP		MAP_REGION_FLAT(PLAT_A600_FIP_BASE,		\
+					PLAT_A600_FIP_MAX_SIZE,		\
+					MT_MEMORY | MT_RO | MT_SECURE)
+
 #ifdef SPD_opteed
 #define MAP_OPTEE_PAGEABLE	MAP_REGION_FLAT(		\
 				A600_OPTEE_PAGEABLE_LOAD_BASE,	\
@@ -72,7 +90,9 @@ static const mmap_region_t plat_a600_mmap[] = {
 	MAP_DEVICE0,
 	MAP_DEVICE1,
 	MAP_DEVICE2,
+	MAP_FIP,
 	MAP_NS_DRAM0,
+	MAP_SEC_DRAM1,
 #ifdef BL32_BASE
 	MAP_BL32_MEM,
 #endif
@@ -88,6 +108,12 @@ static const mmap_region_t plat_a600_mmap[] = {
 #ifdef A600_PRELOADED_DTB_BASE
 	MAP_NS_DTB,
 #endif
+#if A600_CONSOLE_LOG
+	MAP_CONSOLE_LOG,
+#endif
+#if ENABLE_EL3_TRACE
+	MAP_EL3_TRACE,
+#endif
 #ifdef BL32_BASE
 	MAP_BL32_MEM,
 #endif
@@ -102,6 +128,7 @@ static console_16550_t a600_console;
 
 void a600_console_init(void)
 {
+	unsigned long long start = boot_instr_now();
 	int console_scope = CONSOLE_FLAG_BOOT;
 #if A600_RUNTIME_UART != -1
 	console_scope |= CONSOLE_FLAG_RUNTIME;
@@ -120,385 +147,39 @@ void a600_console_init(void)
 	}
 
 	console_set_scope(&a600_console.console, console_scope);
-}
-
-/*******************************************************************************
- * Function that sets up the ddr
- ******************************************************************************/
-void a600_ddr_init(void)
-{
-	unsigned int val;
-	/*
-	 * ==================================
-	 *  FTDDR440 subsystem
-	 * ==================================
-	 *  addr[19:16] = 4'h0 ; cha_dfi
-	 *  addr[19:16] = 4'h1 ; chb_dfi
-	 *  addr[19:16] = 4'h2 ; cha_ctrl
-	 *  addr[19:16] = 4'h3 ; chb_ctrl
-	 *  addr[19:16] = 4'h4 ; cphy
-	 *  addr[19:16] = 4'h5 ; cha_aphy
-	 *  addr[19:16] = 4'h6 ; chb_aphy
-	 *  addr[19:16] = 4'h7 ; cha_dphy_b0
-	 *  addr[19:16] = 4'h8 ; cha_dphy_b1
-	 *  addr[19:16] = 4'h9 ; chb_dphy_b0
-	 *  addr[19:16] = 4'hA ; chb_dphy_b1
-	 * ==================================
-	 */
 
-	mmio_write_32(0x2D080148, 0x00000000);	// disable DDR interleave and assert PHY reset (DDR0_CTRL of secure EXTREG)
-//	mmio_write_32(0x2D080148, 0x00000002);	// enable DDR interleave and assert PHY reset (DDR0_CTRL of secure EXTREG)
-	mdelay(100);
-	mmio_write_32(0x2D080148, 0x00000001);	// disable DDR interleave and release PHY reset (DDR0_CTRL of secure EXTREG)
-//	mmio_write_32(0x2D080148, 0x00000003);	// enable DDR interleave and release PHY reset (DDR0_CTRL of secure EXTREG)
-
-	// ------------------- Step1 - change DDR PLL M/N - start -------------------------------
-
-	// cha_dphy reset assert
-	mmio_write_32(0x2A6700cc, 0x00000002);	//a_dphy_b0
-	mmio_write_32(0x2A6800cc, 0x00000002);	//a_dphy_b1
-	// chb_dphy reset assert
-	mmio_write_32(0x2A6900cc, 0x00000002);	//b_dphy_b0
-	mmio_write_32(0x2A6a00cc, 0x00000002);	//b_dphy_b1
-	// cha_aphy reset assert
-	mmio_write_32(0x2A6500a0, 0x00000002);	//a_aphy
-	// chb_aphy reset assert
-	mmio_write_32(0x2A6600a0, 0x00000002);	//b_aphy
-	// cphy reset assert
-	mmio_write_32(0x2A640058, 0x00000002);	//cphy
-
-	mdelay(100);
-
-	// cphy PLL setting
-	// cphy PLL_CTRL1           0x44= 0x083f4006
-	// m = 10'd533 = 10'h215 =
-	// p = 6'd3
-	// s = 3'd0
-//	mmio_write_32(0x2A640044, 0x123f6403);	//cphy (400mhz)
-//	mmio_write_32(0x2A640044, 0x0A3f6403);	//cphy (800mhz)
-//	mmio_write_32(0x2A640044, 0x0A3F8543);	//cphy (1066mhz)
-//	mmio_write_32(0x2A640044, 0x013F6403);	//cphy (1600mhz)
-//	mmio_write_32(0x2A640044, 0x013F7483);	//cphy (1866mhz)
-	mmio_write_32(0x2A640044, 0x013F8543);	//cphy (2133mhz)
-
-	mdelay(100);
-
-	// cha_dphy reset assert
-	mmio_write_32(0x2A6700cc, 0x00000003);	//a_dphy_b0
-	mmio_write_32(0x2A6800cc, 0x00000003);	//a_dphy_b1
-	// chb_dphy reset assert
-	mmio_write_32(0x2A6900cc, 0x00000003);	//b_dphy_b0
-	mmio_write_32(0x2A6a00cc, 0x00000003);	//b_dphy_b1
-	// cha_aphy reset de-assert
-	mmio_write_32(0x2A6500a0, 0x00000003);	//a_aphy
-	// chb_aphy reset de-assert
-	mmio_write_32(0x2A6600a0, 0x00000003);	//b_aphy
-	// cphy reset de-assert
-	mmio_write_32(0x2A640058, 0x00000003);	//cphy
-
-	// wait to aphy ready - channel A
-	val = mmio_read_32(0x2A6500E0);
-	val &= 0x00100000;
-	while (val != 0x00100000)
-	{
-		val = mmio_read_32(0x2A6500E0);
-		val &= 0x00100000;
-	}
-
-	// wait to aphy ready - channel B
-	val = mmio_read_32(0x2A6600E0);
-	val &= 0x00100000;
-	while (val != 0x00100000)
-	{
-		val = mmio_read_32(0x2A6600E0);
-		val &= 0x00100000;
-	}
-
-	// ------------------- Step1 - change DDR PLL M/N - end -------------------------------
-
-	// ------------------- Step2 - Set FTDDR440 control register - start -------------------------------
-
-	// Channel A ctrl setting
-	mmio_write_32(0x2A620000, 0x08058100);	//Memory Controller Configure (LPDDR4 mode, 16-bits memory width)
-	mmio_write_32(0x2A620020, 0x00103f7c);	//LPDDRx Mode Register Set Values for MR1/MR2/MR3/MR4
-	mmio_write_32(0x2A620038, 0x00000002);	//LPDDRx Additive Latency Register
-	mmio_write_32(0x2A62003c, 0x08000075);	//Rank Information Register (0x80000000, 16x10x3, 1GB)
-	mmio_write_32(0x2A620040, 0x16162217);	//Timing Parameter 0
-	mmio_write_32(0x2A620044, 0x64a18c6a);	//Timing Parameter 1
-	mmio_write_32(0x2A620048, 0x03039a7f);	//Timing Parameter 2
-	mmio_write_32(0x2A62004c, 0x00ff8764);	//Timing Parameter 3
-	mmio_write_32(0x2A620050, 0x0000050a);	//Timing Parameter 4
-	mmio_write_32(0x2A62005c, 0x50000000);	//Timing Parameter 7
-	mmio_write_32(0x2A620060, 0x0000000e);	//Initialization of Waiting Cycle Count 1
-	mmio_write_32(0x2A620064, 0x000000d4);	//Initialization of Waiting Cycle Count 2
-	mmio_write_32(0x2A620068, 0x00000190);	//LPDDR4 2 us Wait Cycle Register
-	mmio_write_32(0x2A62006c, 0x00061a80);	//LPDDR4 2 ms Wait Cycle Register
-	mmio_write_32(0x2A620074, 0x00000000);	//EXIT SRF Control Register
-	mmio_write_32(0x2A620100, 0x001600e5);	//Channel Arbitration Setup Register
-	mmio_write_32(0x2A620104, 0x0f050506);	//Channel Arbiter Grant Count Register - A
-	mmio_write_32(0x2A620108, 0x05080305);	//Channel Arbiter Grant Count Register - B
-	mmio_write_32(0x2A620118, 0x00000002);	//Bandwidth Control Register
-	mmio_write_32(0x2A62011c, 0x03030404);	//Bandwidth Control Command Count Register - A
-	mmio_write_32(0x2A620120, 0x01010202);	//Bandwidth Control Command Count Register - B
-	mmio_write_32(0x2A62012c, 0x00000000);	//Channel QoS Mapping Register
-	mmio_write_32(0x2A620130, 0x00000000);	//AXI4 QoS Mapping Register 0
-	mmio_write_32(0x2A620200, 0x10052008);	//DDRx PHY Write/Read Data Timing Control Register
-	mmio_write_32(0x2A620080, 0x0000aa00);	//Command Flush Control Register
-	mmio_write_32(0x2A620170, 0x00000000);	//Traffic Monitor Clock Cycle Register
-	mmio_write_32(0x2A62008c, 0x81818181);	//AHB INCR Read Prefetch Length 1
-	mmio_write_32(0x2A620090, 0x81818181);	//AHB INCR Read Prefetch Length 2
-	mmio_write_32(0x2A6200a0, 0x00000001);	//DDR ELASTIC FIFO Control Register
-
-	mmio_write_32(0x2A620204, 0x00000010);	//Channel A DFI Training Control Register
-	mmio_write_32(0x2A620210, 0x00000019);
-	mmio_write_32(0x2A620218, 0x00000043);
-	mmio_write_32(0x2A620300, 0x007f007c);	//FSP1 MR2 and MR1
-	mmio_write_32(0x2A620304, 0x00660030);	//FSP1 MR11 and MR3
-	mmio_write_32(0x2A620308, 0x0000000e);	//FSP1 MR13 and MR12
-	mmio_write_32(0x2A62030c, 0x0000000e);	//FSP1 MR22 and MR14
-	mmio_write_32(0x2A620310, 0xa0093818);
-	mmio_write_32(0x2A620314, 0x26847c9a);
-	mmio_write_32(0x2A620318, 0x03031030);
-	mmio_write_32(0x2A62031c, 0x00938764);
-	mmio_write_32(0x2A620320, 0x00000a18);
-	mmio_write_32(0x2A620324, 0x00000000);
-	mmio_write_32(0x2A620328, 0x00000000);
-	mmio_write_32(0x2A62032c, 0x32331414);
-	mmio_write_32(0x2A620330, 0x00000002);
-	mmio_write_32(0x2A620334, 0x000e2011);	//FSP1 wren & trddata_en
-	mmio_write_32(0x2A620338, 0x00000a0a);
-	mmio_write_32(0x2A62033C, 0x000fffff);
-	mmio_write_32(0x2A620340, 0x001b003c);	//FSP2 MR2 and MR1
-	mmio_write_32(0x2A620344, 0x00660010);	//FSP2 MR11 and MR3
-	mmio_write_32(0x2A620348, 0x0000000e);	//FSP2 MR13 and MR12
-	mmio_write_32(0x2A62034c, 0x0000000e);	//FSP2 MR22 and MR14
-	mmio_write_32(0x2A620350, 0x300a120c);
-	mmio_write_32(0x2A620354, 0x02033524);
-	mmio_write_32(0x2A620358, 0x03022421);
-	mmio_write_32(0x2A62035c, 0x00641109);
-	mmio_write_32(0x2A620360, 0x0000090a);
-	mmio_write_32(0x2A620364, 0x00000000);
-	mmio_write_32(0x2A620368, 0x00000000);
-	mmio_write_32(0x2A62036c, 0x32331414);
-	mmio_write_32(0x2A620370, 0x00000002);
-	mmio_write_32(0x2A620374, 0x00052005);	//FSP2 wren & trddata_en
-	mmio_write_32(0x2A620378, 0x00000a0a);
-	mmio_write_32(0x2A62037C, 0x000fffff);
-
-	// Channel B ctrl setting
-	mmio_write_32(0x2A630000, 0x08058100);	//Memory Controller Configure (LPDDR4 mode, 16-bits memory width)
-	mmio_write_32(0x2A630020, 0x00103f7c);	//LPDDRx Mode Register Set Values for MR1/MR2/MR3/MR4
-	mmio_write_32(0x2A630038, 0x00000002);	//LPDDRx Additive Latency Register
-	mmio_write_32(0x2A63003c, 0x0C000075);	//Rank Information Register (0xC0000000, 16x10x3, 1GB)
-	mmio_write_32(0x2A630040, 0x16162217);	//Timing Parameter 0
-	mmio_write_32(0x2A630044, 0x64a18c6a);	//Timing Parameter 1
-	mmio_write_32(0x2A630048, 0x03039a7f);	//Timing Parameter 2
-	mmio_write_32(0x2A63004c, 0x00ff8764);	//Timing Parameter 3
-	mmio_write_32(0x2A630050, 0x0000050a);	//Timing Parameter 4
-	mmio_write_32(0x2A63005c, 0x50000000);	//Timing Parameter 7
-	mmio_write_32(0x2A630060, 0x0000000e);	//Initialization of Waiting Cycle Count 1
-	mmio_write_32(0x2A630064, 0x000000d4);	//Initialization of Waiting Cycle Count 2
-	mmio_write_32(0x2A630068, 0x00000190);	//LPDDR4 2 us Wait Cycle Register
-	mmio_write_32(0x2A63006c, 0x00061a80);	//LPDDR4 2 ms Wait Cycle Register
-	mmio_write_32(0x2A630074, 0x00000000);	//EXIT SRF Control Register
-	mmio_write_32(0x2A630100, 0x001600e5);	//Channel Arbitration Setup Register
-	mmio_write_32(0x2A630104, 0x0f050506);	//Channel Arbiter Grant Count Register - A
-	mmio_write_32(0x2A630108, 0x05080305);	//Channel Arbiter Grant Count Register - B
-	mmio_write_32(0x2A630118, 0x00000002);	//Bandwidth Control Register
-	mmio_write_32(0x2A63011c, 0x03030404);	//Bandwidth Control Command Count Register - A
-	mmio_write_32(0x2A630120, 0x01010202);	//Bandwidth Control Command Count Register - B
-	mmio_write_32(0x2A63012c, 0x00000000);	//Channel QoS Mapping Register
-	mmio_write_32(0x2A630130, 0x00000000);	//AXI4 QoS Mapping Register 0
-	mmio_write_32(0x2A630200, 0x10052008);	//DDRx PHY Write/Read Data Timing Control Register
-	mmio_write_32(0x2A630080, 0x0000aa00);	//Command Flush Control Register
-	mmio_write_32(0x2A630170, 0x00000000);	//Traffic Monitor Clock Cycle Register
-	mmio_write_32(0x2A63008c, 0x81818181);	//AHB INCR Read Prefetch Length 1
-	mmio_write_32(0x2A630090, 0x81818181);	//AHB INCR Read Prefetch Length 2
-	mmio_write_32(0x2A6300a0, 0x00000001);	//DDR ELASTIC FIFO Control Register
-
-	mmio_write_32(0x2A630204, 0x00000010);	//Channel B DFI Training Control Register
-	mmio_write_32(0x2A630210, 0x00000019);
-	mmio_write_32(0x2A630218, 0x00000043);
-	mmio_write_32(0x2A630300, 0x007f007c);	//FSP1 MR2 and MR1
-	mmio_write_32(0x2A630304, 0x00660030);	//FSP1 MR11 and MR3
-	mmio_write_32(0x2A630308, 0x0000000e);	//FSP1 MR13 and MR12
-	mmio_write_32(0x2A63030c, 0x0000000e);	//FSP1 MR22 and MR14
-	mmio_write_32(0x2A630310, 0xa0093818);
-	mmio_write_32(0x2A630314, 0x26847c9a);
-	mmio_write_32(0x2A630318, 0x03031030);
-	mmio_write_32(0x2A63031c, 0x00938764);
-	mmio_write_32(0x2A630320, 0x00000a18);
-	mmio_write_32(0x2A630324, 0x00000000);
-	mmio_write_32(0x2A630328, 0x00000000);
-	mmio_write_32(0x2A63032c, 0x32331414);
-	mmio_write_32(0x2A630330, 0x00000002);
-	mmio_write_32(0x2A630334, 0x000e2011);	//FSP1 wren & trddata_en
-	mmio_write_32(0x2A630338, 0x00000a0a);
-	mmio_write_32(0x2A63033C, 0x000fffff);
-	mmio_write_32(0x2A630340, 0x001b003c);	//FSP2 MR2 and MR1
-	mmio_write_32(0x2A630344, 0x00660010);	//FSP2 MR11 and MR3
-	mmio_write_32(0x2A630348, 0x0000000e);	//FSP2 MR13 and MR12
-	mmio_write_32(0x2A63034c, 0x0000000e);	//FSP2 MR22 and MR14
-	mmio_write_32(0x2A630350, 0x300a120c);
-	mmio_write_32(0x2A630354, 0x02033524);
-	mmio_write_32(0x2A630358, 0x03032421);
-	mmio_write_32(0x2A63035c, 0x00641109);
-	mmio_write_32(0x2A630360, 0x0000090a);
-	mmio_write_32(0x2A630364, 0x00000000);
-	mmio_write_32(0x2A630368, 0x00000000);
-	mmio_write_32(0x2A63036c, 0x32331414);
-	mmio_write_32(0x2A630370, 0x00000002);
-	mmio_write_32(0x2A630374, 0x00052005);
-	mmio_write_32(0x2A630378, 0x00000a0a);
-	mmio_write_32(0x2A63037C, 0x000fffff);
-
-	// ------------------- Step2 - Set FTDDR440 control register - end -------------------------------
-
-	// ------------------- Step3 - Set pin swap - start -------------------------------
-
-//	mmio_write_32(0x2A6001B0, 0x00000001);	//D PHY Byte Swap
-	mmio_write_32(0x2A600160, 0x02105423);	//CA PHY Pin Swap Register 0
-	mmio_write_32(0x2A600164, 0x0000001e);	//CA PHY Pin Swap Register 1
-	mmio_write_32(0x2A6001C0, 0x32104756);	//D PHY Byte0 Swap regsiter 0
-	mmio_write_32(0x2A6001C4, 0x20137654);	//D PHY Byte0 Swap regsiter 1
-	mmio_write_32(0x2A6001C8, 0x32104756);	//D PHY Byte0 Swap regsiter 2
-	mmio_write_32(0x2A6001D0, 0x45673021);	//D PHY Byte1 Swap regsiter 0
-	mmio_write_32(0x2A6001D4, 0x45673102);	//D PHY Byte1 Swap regsiter 1
-	mmio_write_32(0x2A6001D8, 0x45673021);	//D PHY Byte1 Swap regsiter 2
-//	mmio_write_32(0x2A6101B0, 0x00000001);	//D PHY Byte Swap
-	mmio_write_32(0x2A610160, 0x02105243);	//CA PHY Pin Swap Register 0
-	mmio_write_32(0x2A610164, 0x0000001b);	//CA PHY Pin Swap Register 1
-	mmio_write_32(0x2A6101C0, 0x45673021);	//D PHY Byte0 Swap regsiter 0
-	mmio_write_32(0x2A6101C4, 0x45673102);	//D PHY Byte0 Swap regsiter 1
-	mmio_write_32(0x2A6101C8, 0x45673021);	//D PHY Byte0 Swap regsiter 2
-	mmio_write_32(0x2A6101D0, 0x32104756);	//D PHY Byte1 Swap regsiter 0
-	mmio_write_32(0x2A6101D4, 0x20137654);	//D PHY Byte1 Swap regsiter 1
-	mmio_write_32(0x2A6101D8, 0x32104756);	//D PHY Byte1 Swap regsiter 2
-
-	// ------------------- Step3 - Set pin swap - end -------------------------------
-
-	// ------------------- Step4 - Set FTDFIW400 control register - start -------------------------------
-
-	// Channel A setting
-	mmio_write_32(0x2A600004, 0x00031c00);	//set freq_set_point
-	mmio_write_32(0x2A60000c, 0x00000000);	//disable update control
-	mmio_write_32(0x2A600010, 0x00000000);	//disable update control
-	mmio_write_32(0x2A600014, 0x00000000);	//disable update control
-	mmio_write_32(0x2A600020, 0x00120e5c);	//cbt
-	mmio_write_32(0x2A600028, 0x01030014);	//weye/reye per-bit
-	mmio_write_32(0x2A60002C, 0x10000054);	//weye setting
-	mmio_write_32(0x2A600030, 0x55555555);	//weye external pattern
-	mmio_write_32(0x2A600034, 0x5523201c);	//rvref setting
-	mmio_write_32(0x2A60003C, 0x01180100);	//wvref setting
-	mmio_write_32(0x2A600040, 0x00040204);	//FSP2's DFI timing setting
-	mmio_write_32(0x2A600044, 0x00080210);	//FSP1's DFI timing setting
-	mmio_write_32(0x2A600048, 0x0d0b060e);	//FSP2's timing setting
-	mmio_write_32(0x2A60004c, 0x1e1e1e1e);	//FSP1's timing setting
-	mmio_write_32(0x2A600050, 0x25241102);	//FSP2's timing setting
-	mmio_write_32(0x2A600054, 0x858a1e0f);	//FSP1's timing setting
-	mmio_write_32(0x2A600058, 0x40050325);	//FSP2's timing setting
-	mmio_write_32(0x2A60005c, 0xf0100f25);	//FSP1's timing setting
-	mmio_write_32(0x2A600060, 0x20040507);	//FSP2's timing setting
-	mmio_write_32(0x2A600064, 0xa00f100f);	//FSP1's timing setting
-	mmio_write_32(0x2A600068, 0x00002b56);	//FSP2's timing setting
-	mmio_write_32(0x2A60006c, 0x0000ffff);	//FSP1's timing setting
-	mmio_write_32(0x2A600080, 0x0010001b);	//FSP2's MR3, MR2, RL=20, WL=10
-	mmio_write_32(0x2A600084, 0x0010007f);	//FSP1's MR3, MR2, RL=36, WL=34
-	mmio_write_32(0x2A600088, 0x00000000);	//MR13
-	mmio_write_32(0x2A600100, 0x07ff07ff);	//FSP0's caphdly and csdly
-	mmio_write_32(0x2A600238, 0x00002000);	//FSP2's R0 B0 RVREF
-	mmio_write_32(0x2A60023C, 0x00002000);	//FSP1's R0 B0 RVREF
-	mmio_write_32(0x2A600338, 0x00002000);	//FSP2's R0 B1 RVREF
-	mmio_write_32(0x2A60033C, 0x00002000);	//FSP1's R0 B1 RVREF
-
-	// Channel B setting
-	mmio_write_32(0x2A610004, 0x00031c00);	//set freq_set_point
-	mmio_write_32(0x2A61000c, 0x00000000);	//disable update control
-	mmio_write_32(0x2A610010, 0x00000000);	//disable update control
-	mmio_write_32(0x2A610014, 0x00000000);	//disable update control
-	mmio_write_32(0x2A610020, 0x00120e5c);	//cbt
-	mmio_write_32(0x2A610028, 0x01030014);	//weye/reye per-bit
-	mmio_write_32(0x2A61002C, 0x10000054);	//weye setting
-	mmio_write_32(0x2A610030, 0x55555555);	//weye external pattern
-	mmio_write_32(0x2A610034, 0x5523201c);	//rvref setting
-	mmio_write_32(0x2A61003C, 0x01180100);	//wvref setting
-	mmio_write_32(0x2A610040, 0x00040204);	//FSP2's DFI timing setting
-	mmio_write_32(0x2A610044, 0x00080210);	//FSP1's DFI timing setting
-	mmio_write_32(0x2A610048, 0x0d0b060e);	//FSP2's timing setting
-	mmio_write_32(0x2A61004c, 0x1e1e1e1e);	//FSP1's timing setting
-	mmio_write_32(0x2A610050, 0x25241102);	//FSP2's timing setting
-	mmio_write_32(0x2A610054, 0x858a1e0f);	//FSP1's timing setting
-	mmio_write_32(0x2A610058, 0x40050325);	//FSP2's timing setting
-	mmio_write_32(0x2A61005c, 0xf0100f25);	//FSP1's timing setting
-	mmio_write_32(0x2A610060, 0x20040507);	//FSP2's timing setting
-	mmio_write_32(0x2A610064, 0xa00f100f);	//FSP1's timing setting
-	mmio_write_32(0x2A610068, 0x00002b56);	//FSP2's timing setting
-	mmio_write_32(0x2A61006c, 0x0000ffff);	//FSP1's timing setting
-	mmio_write_32(0x2A610080, 0x0010001b);	//FSP2's MR3, MR2, RL=20, WL=10
-	mmio_write_32(0x2A610084, 0x0010007f);	//FSP1's MR3, MR2, RL=36, WL=34
-	mmio_write_32(0x2A610088, 0x00000000);	//MR13
-	mmio_write_32(0x2A610100, 0x07ff07ff);	//FSP0's caphdly and csdly
-	mmio_write_32(0x2A610238, 0x00002000);	//FSP2's R0 B0 RVREF
-	mmio_write_32(0x2A61023C, 0x00002000);	//FSP1's R0 B0 RVREF
-	mmio_write_32(0x2A610338, 0x00002000);	//FSP2's R0 B1 RVREF
-	mmio_write_32(0x2A61033C, 0x00002000);	//FSP1's R0 B1 RVREF
-
-	// ------------------- Step4 - Set FTDFIW400 control register - end -------------------------------
-
-	// ------------------- Step5 - Change to boot frequency and enable the training - start -------------------------------
-
-	mmio_write_32(0x2A600004, 0x00039c7f);	//enable wrlvl, reye, wl2nd, weye
-	mmio_write_32(0x2A610004, 0x00039c7f);	//enable wrlvl, reye, wl2nd, weye
-
-	// wait to cha_dfi boot sequence completed
-	val = mmio_read_32(0x2A600004);
-	val &= 0x00008000;
-	while (val == 0x00008000)
-	{
-		val = mmio_read_32(0x2A600004);
-		val &= 0x00008000;
-	}
-
-	// wait to chb_dfi boot sequence completed
-	val = mmio_read_32(0x2A610004);
-	val &= 0x00008000;
-	while (val == 0x00008000)
-	{
-		val = mmio_read_32(0x2A610004);
-		val &= 0x00008000;
-	}
-
-	// ------------------- Step5 - Change to boot frequency and enable the training - end -------------------------------
+	boot_instr_add(BOOT_INSTR_CONSOLE_INIT, start);
+}
 
-	// ------------------- Step6 - Trigger DDR initialization and Training - start -------------------------------
+#if defined(IMAGE_BL31) && A600_CONSOLE_LOG
+CASSERT((PLATFORM_CORE_COUNT *
+	 CONSOLE_LOG_RING_STRIDE(PLAT_A600_CONSOLE_LOG_RING_SIZE)) <=
+	PLAT_A600_CONSOLE_LOG_SIZE, assert_console_log_size);
 
-	mmio_write_32(0x2A620204, 0x00000011);	//DFI Training Control Register (dfi_auto_init_en)
-	mmio_write_32(0x2A630204, 0x00000011);	//DFI Training Control Register (dfi_auto_init_en)
-	mmio_write_32(0x2A620004, 0x00000001);	//Memory Controller Command Register (Initial command)
-	mmio_write_32(0x2A630004, 0x00000001);	//Memory Controller Command Register (Initial command)
+/* Checked by the crash console before it sends what is left in the log */
+uint32_t a600_console_log_enabled;
 
-	// wait to DDR0 init_ok
-	// @(posedge AXI_TB.AXI_Core.U_DDR_TOP.init_ok_u0);
-	val = mmio_read_32(0x2D080148);
-	val &= 0x80000000;
-	while (val != 0x80000000)
-	{
-		val = mmio_read_32(0x2D080148);
-		val &= 0x80000000;
+/*
+ * Buffer the console in the log region, so that printing doesn't wait for the
+ * UART. This needs the MMU on, the log region and the lock of the buffered
+ * console have to be in cacheable memory.
+ */
+void a600_console_log_init(void)
+{
+	int rc = console_buffered_register(&a600_console.console,
+					   console_16550_tx_burst,
+					   PLAT_A600_CONSOLE_LOG_BASE,
+					   PLAT_A600_CONSOLE_LOG_RING_SIZE);
+	if (rc == 0) {
+		panic();
 	}
 
-	// wait to DDR1 init_ok
-	// @(posedge AXI_TB.AXI_Core.U_DDR_TOP.init_ok_u1);
-	val = mmio_read_32(0x2D08014C);
-	val &= 0x80000000;
-	while (val != 0x80000000)
-	{
-		val = mmio_read_32(0x2D08014C);
-		val &= 0x80000000;
-	}
-//	mdelay(3000);
-	// ------------------- Step6 - Trigger DDR initialization and Training - end -------------------------------
+	/* The crash console may run with the MMU off */
+	a600_console_log_enabled = 1U;
+	flush_dcache_range((uintptr_t)&a600_console_log_enabled,
+			   sizeof(a600_console_log_enabled));
 }
+#endif
 
 /*******************************************************************************
  * Function that sets up the ddr
@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/delay_timer.h>
+#include <drivers/generic_delay_timer.h>
+#include <lib/boot_instr.h>
+#include <lib/mmio.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+
+#include "a600_private.h"
+
+/*
+ * ==================================
+ *  FTDDR440 subsystem
+ * ==================================
+ *  addr[19:16] = 4'h0 ; cha_dfi
+ *  addr[19:16] = 4'h1 ; chb_dfi
+ *  addr[19:16] = 4'h2 ; cha_ctrl
+ *  addr[19:16] = 4'h3 ; chb_ctrl
+ *  addr[19:16] = 4'h4 ; cphy
+ *  addr[19:16] = 4'h5 ; cha_aphy
+ *  addr[19:16] = 4'h6 ; chb_aphy
+ *  addr[19:16] = 4'h7 ; cha_dphy_b0
+ *  addr[19:16] = 4'h8 ; cha_dphy_b1
+ *  addr[19:16] = 4'h9 ; chb_dphy_b0
+ *  addr[19:16] = 4'hA ; chb_dphy_b1
+ * ==================================
+ */
+#define DDR_CHA_DFI_BOOT		U(0x2A600004)
+#define DDR_CHB_DFI_BOOT		U(0x2A610004)
+#define DDR_CPHY_PLL_CTRL1		U(0x2A640044)
+#define DDR_CHA_APHY_STATUS		U(0x2A6500E0)
+#define DDR_CHB_APHY_STATUS		U(0x2A6600E0)
+
+/* DDR0_CTRL/DDR1_CTRL of the secure EXTREG */
+#define DDR0_CTRL			U(0x2D080148)
+#define DDR1_CTRL			U(0x2D08014C)
+#define DDR_CTRL_PHY_RSTN		BIT_32(0)
+#define DDR_CTRL_INTERLEAVE		BIT_32(1)
+#define DDR_CTRL_INIT_OK		BIT_32(31)
+
+#define DDR_APHY_READY			BIT_32(20)
+#define DDR_DFI_BOOT_BUSY		BIT_32(15)
+
+/*
+ * Reset pulse width. The PHY has no status bit for an asserted reset, and no
+ * minimum pulse width is documented for it, so this keeps the 100 ms wait of
+ * the Faraday reference init sequence.
+ */
+#define DDR_RST_PULSE_US		U(100000)
+
+/*
+ * Settling time of the cphy PLL after a new PLL_CTRL1 setting, before the PHY
+ * resets are released. The cphy exposes no PLL lock bit, and the APHY ready
+ * bits are only meaningful once the PHY is out of reset, so this keeps the
+ * 100 ms wait of the Faraday reference init sequence.
+ */
+#define DDR_PLL_SETTLE_US		U(100000)
+
+/* Upper bounds for the hardware handshakes, not expected durations. */
+#define DDR_APHY_READY_TIMEOUT_US	U(100000)
+#define DDR_DFI_BOOT_TIMEOUT_US		U(100000)
+#define DDR_INIT_OK_TIMEOUT_US		U(1000000)
+
+/*******************************************************************************
+ * DDR initialisation is described as tables of register accesses that are run
+ * by a600_ddr_run_seq(). Each step is one of:
+ *
+ *   DDR_WRITE(addr, val)		write `val` to `addr`
+ *   DDR_RMW(addr, clr, set)		clear `clr` then set `set` bits in `addr`
+ *   DDR_POLL(addr, mask, val, us)	wait until (`addr` & `mask`) == `val`,
+ *					failing after `us` microseconds
+ *   DDR_DELAY_US(us)			wait for `us` microseconds
+ ******************************************************************************/
+#define DDR_OP_WRITE			U(0)
+#define DDR_OP_RMW			U(1)
+#define DDR_OP_POLL			U(2)
+#define DDR_OP_DELAY			U(3)
+
+typedef struct a600_ddr_step {
+	uint32_t op;
+	uint32_t addr;
+	uint32_t mask;
+	uint32_t val;
+	uint32_t time_us;
+} a600_ddr_step_t;
+
+typedef struct a600_ddr_seq {
+	const char *name;
+	const a600_ddr_step_t *steps;
+	unsigned int num_steps;
+} a600_ddr_seq_t;
+
+typedef struct a600_ddr_profile {
+	unsigned int freq_mhz;
+	a600_ddr_seq_t pll;
+} a600_ddr_profile_t;
+
+/* Time spent in one sequence, in system counter ticks */
+typedef struct a600_ddr_seq_stats {
+	uint64_t total;
+	uint64_t slowest;
+	unsigned int slowest_step;
+} a600_ddr_seq_stats_t;
+
+#define DDR_WRITE(_addr, _val)						\
+	{ .op = DDR_OP_WRITE, .addr = (_addr), .val = (_val) }
+#define DDR_RMW(_addr, _clr, _set)					\
+	{ .op = DDR_OP_RMW, .addr = (_addr), .mask = (_clr), .val = (_set) }
+#define DDR_POLL(_addr, _mask, _val, _us)				\
+	{ .op = DDR_OP_POLL, .addr = (_addr), .mask = (_mask),		\
+	  .val = (_val), .time_us = (_us) }
+#define DDR_DELAY_US(_us)						\
+	{ .op = DDR_OP_DELAY, .time_us = (_us) }
+
+#define DDR_SEQ(_name, _steps)						\
+	{ .name = (_name), .steps = (_steps),				\
+	  .num_steps = ARRAY_SIZE(_steps) }
+
+/* ------------------- Step1 - change DDR PLL M/N ------------------------- */
+
+static const a600_ddr_step_t a600_ddr_phy_reset[] = {
+	/* disable DDR interleave and assert PHY reset */
+	DDR_WRITE(DDR0_CTRL, 0),
+	DDR_DELAY_US(DDR_RST_PULSE_US),
+	/* release PHY reset */
+	DDR_RMW(DDR0_CTRL, 0, DDR_CTRL_PHY_RSTN),
+
+	/* cha_dphy reset assert */
+	DDR_WRITE(0x2A6700cc, 0x00000002),	/* a_dphy_b0 */
+	DDR_WRITE(0x2A6800cc, 0x00000002),	/* a_dphy_b1 */
+	/* chb_dphy reset assert */
+	DDR_WRITE(0x2A6900cc, 0x00000002),	/* b_dphy_b0 */
+	DDR_WRITE(0x2A6a00cc, 0x00000002),	/* b_dphy_b1 */
+	/* cha_aphy reset assert */
+	DDR_WRITE(0x2A6500a0, 0x00000002),	/* a_aphy */
+	/* chb_aphy reset assert */
+	DDR_WRITE(0x2A6600a0, 0x00000002),	/* b_aphy */
+	/* cphy reset assert */
+	DDR_WRITE(0x2A640058, 0x00000002),	/* cphy */
+	DDR_DELAY_US(DDR_RST_PULSE_US),
+};
+
+/*
+ * cphy PLL_CTRL1 (0x44) for each supported data rate, e.g. 2133 MHz is
+ * m = 10'd533, p = 6'd3, s = 3'd0.
+ */
+static const a600_ddr_step_t a600_ddr_pll_400[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x123f6403),
+};
+
+static const a600_ddr_step_t a600_ddr_pll_800[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x0A3f6403),
+};
+
+static const a600_ddr_step_t a600_ddr_pll_1066[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x0A3F8543),
+};
+
+static const a600_ddr_step_t a600_ddr_pll_1600[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x013F6403),
+};
+
+static const a600_ddr_step_t a600_ddr_pll_1866[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x013F7483),
+};
+
+static const a600_ddr_step_t a600_ddr_pll_2133[] = {
+	DDR_WRITE(DDR_CPHY_PLL_CTRL1, 0x013F8543),
+};
+
+static const a600_ddr_profile_t a600_ddr_profiles[] = {
+	{  400, DDR_SEQ("pll-400", a600_ddr_pll_400) },
+	{  800, DDR_SEQ("pll-800", a600_ddr_pll_800) },
+	{ 1066, DDR_SEQ("pll-1066", a600_ddr_pll_1066) },
+	{ 1600, DDR_SEQ("pll-1600", a600_ddr_pll_1600) },
+	{ 1866, DDR_SEQ("pll-1866", a600_ddr_pll_1866) },
+	{ 2133, DDR_SEQ("pll-2133", a600_ddr_pll_2133) },
+};
+
+static const a600_ddr_step_t a600_ddr_phy_release[] = {
+	/* let the cphy PLL settle on its new setting */
+	DDR_DELAY_US(DDR_PLL_SETTLE_US),
+
+	/* cha_dphy reset de-assert */
+	DDR_WRITE(0x2A6700cc, 0x00000003),	/* a_dphy_b0 */
+	DDR_WRITE(0x2A6800cc, 0x00000003),	/* a_dphy_b1 */
+	/* chb_dphy reset de-assert */
+	DDR_WRITE(0x2A6900cc, 0x00000003),	/* b_dphy_b0 */
+	DDR_WRITE(0x2A6a00cc, 0x00000003),	/* b_dphy_b1 */
+	/* cha_aphy reset de-assert */
+	DDR_WRITE(0x2A6500a0, 0x00000003),	/* a_aphy */
+	/* chb_aphy reset de-assert */
+	DDR_WRITE(0x2A6600a0, 0x00000003),	/* b_aphy */
+	/* cphy reset de-assert */
+	DDR_WRITE(0x2A640058, 0x00000003),	/* cphy */
+
+	/* wait to aphy ready - channel A and B */
+	DDR_POLL(DDR_CHA_APHY_STATUS, DDR_APHY_READY, DDR_APHY_READY,
+		 DDR_APHY_READY_TIMEOUT_US),
+	DDR_POLL(DDR_CHB_APHY_STATUS, DDR_APHY_READY, DDR_APHY_READY,
+		 DDR_APHY_READY_TIMEOUT_US),
+};
+
+/* ------------------- Step2 - Set FTDDR440 control register -------------- */
+
+static const a600_ddr_step_t a600_ddr_ctrl[] = {
+	/* Channel A ctrl setting */
+	DDR_WRITE(0x2A620000, 0x08058100),	/* Memory Controller Configure (LPDDR4 mode, 16-bits memory width) */
+	DDR_WRITE(0x2A620020, 0x00103f7c),	/* LPDDRx Mode Register Set Values for MR1/MR2/MR3/MR4 */
+	DDR_WRITE(0x2A620038, 0x00000002),	/* LPDDRx Additive Latency Register */
+	DDR_WRITE(0x2A62003c, 0x08000075),	/* Rank Information Register (0x80000000, 16x10x3, 1GB) */
+	DDR_WRITE(0x2A620040, 0x16162217),	/* Timing Parameter 0 */
+	DDR_WRITE(0x2A620044, 0x64a18c6a),	/* Timing Parameter 1 */
+	DDR_WRITE(0x2A620048, 0x03039a7f),	/* Timing Parameter 2 */
+	DDR_WRITE(0x2A62004c, 0x00ff8764),	/* Timing Parameter 3 */
+	DDR_WRITE(0x2A620050, 0x0000050a),	/* Timing Parameter 4 */
+	DDR_WRITE(0x2A62005c, 0x50000000),	/* Timing Parameter 7 */
+	DDR_WRITE(0x2A620060, 0x0000000e),	/* Initialization of Waiting Cycle Count 1 */
+	DDR_WRITE(0x2A620064, 0x000000d4),	/* Initialization of Waiting Cycle Count 2 */
+	DDR_WRITE(0x2A620068, 0x00000190),	/* LPDDR4 2 us Wait Cycle Register */
+	DDR_WRITE(0x2A62006c, 0x00061a80),	/* LPDDR4 2 ms Wait Cycle Register */
+	DDR_WRITE(0x2A620074, 0x00000000),	/* EXIT SRF Control Register */
+	DDR_WRITE(0x2A620100, 0x001600e5),	/* Channel Arbitration Setup Register */
+	DDR_WRITE(0x2A620104, 0x0f050506),	/* Channel Arbiter Grant Count Register - A */
+	DDR_WRITE(0x2A620108, 0x05080305),	/* Channel Arbiter Grant Count Register - B */
+	DDR_WRITE(0x2A620118, 0x00000002),	/* Bandwidth Control Register */
+	DDR_WRITE(0x2A62011c, 0x03030404),	/* Bandwidth Control Command Count Register - A */
+	DDR_WRITE(0x2A620120, 0x01010202),	/* Bandwidth Control Command Count Register - B */
+	DDR_WRITE(0x2A62012c, 0x00000000),	/* Channel QoS Mapping Register */
+	DDR_WRITE(0x2A620130, 0x00000000),	/* AXI4 QoS Mapping Register 0 */
+	DDR_WRITE(0x2A620200, 0x10052008),	/* DDRx PHY Write/Read Data Timing Control Register */
+	DDR_WRITE(0x2A620080, 0x0000aa00),	/* Command Flush Control Register */
+	DDR_WRITE(0x2A620170, 0x00000000),	/* Traffic Monitor Clock Cycle Register */
+	DDR_WRITE(0x2A62008c, 0x81818181),	/* AHB INCR Read Prefetch Length 1 */
+	DDR_WRITE(0x2A620090, 0x81818181),	/* AHB INCR Read Prefetch Length 2 */
+	DDR_WRITE(0x2A6200a0, 0x00000001),	/* DDR ELASTIC FIFO Control Register */
+
+	DDR_WRITE(0x2A620204, 0x00000010),	/* Channel A DFI Training Control Register */
+	DDR_WRITE(0x2A620210, 0x00000019),
+	DDR_WRITE(0x2A620218, 0x00000043),
+	DDR_WRITE(0x2A620300, 0x007f007c),	/* FSP1 MR2 and MR1 */
+	DDR_WRITE(0x2A620304, 0x00660030),	/* FSP1 MR11 and MR3 */
+	DDR_WRITE(0x2A620308, 0x0000000e),	/* FSP1 MR13 and MR12 */
+	DDR_WRITE(0x2A62030c, 0x0000000e),	/* FSP1 MR22 and MR14 */
+	DDR_WRITE(0x2A620310, 0xa0093818),
+	DDR_WRITE(0x2A620314, 0x26847c9a),
+	DDR_WRITE(0x2A620318, 0x03031030),
+	DDR_WRITE(0x2A62031c, 0x00938764),
+	DDR_WRITE(0x2A620320, 0x00000a18),
+	DDR_WRITE(0x2A620324, 0x00000000),
+	DDR_WRITE(0x2A620328, 0x00000000),
+	DDR_WRITE(0x2A62032c, 0x32331414),
+	DDR_WRITE(0x2A620330, 0x00000002),
+	DDR_WRITE(0x2A620334, 0x000e2011),	/* FSP1 wren & trddata_en */
+	DDR_WRITE(0x2A620338, 0x00000a0a),
+	DDR_WRITE(0x2A62033C, 0x000fffff),
+	DDR_WRITE(0x2A620340, 0x001b003c),	/* FSP2 MR2 and MR1 */
+	DDR_WRITE(0x2A620344, 0x00660010),	/* FSP2 MR11 and MR3 */
+	DDR_WRITE(0x2A620348, 0x0000000e),	/* FSP2 MR13 and MR12 */
+	DDR_WRITE(0x2A62034c, 0x0000000e),	/* FSP2 MR22 and MR14 */
+	DDR_WRITE(0x2A620350, 0x300a120c),
+	DDR_WRITE(0x2A620354, 0x02033524),
+	DDR_WRITE(0x2A620358, 0x03022421),
+	DDR_WRITE(0x2A62035c, 0x00641109),
+	DDR_WRITE(0x2A620360, 0x0000090a),
+	DDR_WRITE(0x2A620364, 0x00000000),
+	DDR_WRITE(0x2A620368, 0x00000000),
+	DDR_WRITE(0x2A62036c, 0x32331414),
+	DDR_WRITE(0x2A620370, 0x00000002),
+	DDR_WRITE(0x2A620374, 0x00052005),	/* FSP2 wren & trddata_en */
+	DDR_WRITE(0x2A620378, 0x00000a0a),
+	DDR_WRITE(0x2A62037C, 0x000fffff),
+
+	/* Channel B ctrl setting */
+	DDR_WRITE(0x2A630000, 0x08058100),	/* Memory Controller Configure (LPDDR4 mode, 16-bits memory width) */
+	DDR_WRITE(0x2A630020, 0x00103f7c),	/* LPDDRx Mode Register Set Values for MR1/MR2/MR3/MR4 */
+	DDR_WRITE(0x2A630038, 0x00000002),	/* LPDDRx Additive Latency Register */
+	DDR_WRITE(0x2A63003c, 0x0C000075),	/* Rank Information Register (0xC0000000, 16x10x3, 1GB) */
+	DDR_WRITE(0x2A630040, 0x16162217),	/* Timing Parameter 0 */
+	DDR_WRITE(0x2A630044, 0x64a18c6a),	/* Timing Parameter 1 */
+	DDR_WRITE(0x2A630048, 0x03039a7f),	/* Timing Parameter 2 */
+	DDR_WRITE(0x2A63004c, 0x00ff8764),	/* Timing Parameter 3 */
+	DDR_WRITE(0x2A630050, 0x0000050a),	/* Timing Parameter 4 */
+	DDR_WRITE(0x2A63005c, 0x50000000),	/* Timing Parameter 7 */
+	DDR_WRITE(0x2A630060, 0x0000000e),	/* Initialization of Waiting Cycle Count 1 */
+	DDR_WRITE(0x2A630064, 0x000000d4),	/* Initialization of Waiting Cycle Count 2 */
+	DDR_WRITE(0x2A630068, 0x00000190),	/* LPDDR4 2 us Wait Cycle Register */
+	DDR_WRITE(0x2A63006c, 0x00061a80),	/* LPDDR4 2 ms Wait Cycle Register */
+	DDR_WRITE(0x2A630074, 0x00000000),	/* EXIT SRF Control Register */
+	DDR_WRITE(0x2A630100, 0x001600e5),	/* Channel Arbitration Setup Register */
+	DDR_WRITE(0x2A630104, 0x0f050506),	/* Channel Arbiter Grant Count Register - A */
+	DDR_WRITE(0x2A630108, 0x05080305),	/* Channel Arbiter Grant Count Register - B */
+	DDR_WRITE(0x2A630118, 0x00000002),	/* Bandwidth Control Register */
+	DDR_WRITE(0x2A63011c, 0x03030404),	/* Bandwidth Control Command Count Register - A */
+	DDR_WRITE(0x2A630120, 0x01010202),	/* Bandwidth Control Command Count Register - B */
+	DDR_WRITE(0x2A63012c, 0x00000000),	/* Channel QoS Mapping Register */
+	DDR_WRITE(0x2A630130, 0x00000000),	/* AXI4 QoS Mapping Register 0 */
+	DDR_WRITE(0x2A630200, 0x10052008),	/* DDRx PHY Write/Read Data Timing Control Register */
+	DDR_WRITE(0x2A630080, 0x0000aa00),	/* Command Flush Control Register */
+	DDR_WRITE(0x2A630170, 0x00000000),	/* Traffic Monitor Clock Cycle Register */
+	DDR_WRITE(0x2A63008c, 0x81818181),	/* AHB INCR Read Prefetch Length 1 */
+	DDR_WRITE(0x2A630090, 0x81818181),	/* AHB INCR Read Prefetch Length 2 */
+	DDR_WRITE(0x2A6300a0, 0x00000001),	/* DDR ELASTIC FIFO Control Register */
+
+	DDR_WRITE(0x2A630204, 0x00000010),	/* Channel B DFI Training Control Register */
+	DDR_WRITE(0x2A630210, 0x00000019),
+	DDR_WRITE(0x2A630218, 0x00000043),
+	DDR_WRITE(0x2A630300, 0x007f007c),	/* FSP1 MR2 and MR1 */
+	DDR_WRITE(0x2A630304, 0x00660030),	/* FSP1 MR11 and MR3 */
+	DDR_WRITE(0x2A630308, 0x0000000e),	/* FSP1 MR13 and MR12 */
+	DDR_WRITE(0x2A63030c, 0x0000000e),	/* FSP1 MR22 and MR14 */
+	DDR_WRITE(0x2A630310, 0xa0093818),
+	DDR_WRITE(0x2A630314, 0x26847c9a),
+	DDR_WRITE(0x2A630318, 0x03031030),
+	DDR_WRITE(0x2A63031c, 0x00938764),
+	DDR_WRITE(0x2A630320, 0x00000a18),
+	DDR_WRITE(0x2A630324, 0x00000000),
+	DDR_WRITE(0x2A630328, 0x00000000),
+	DDR_WRITE(0x2A63032c, 0x32331414),
+	DDR_WRITE(0x2A630330, 0x00000002),
+	DDR_WRITE(0x2A630334, 0x000e2011),	/* FSP1 wren & trddata_en */
+	DDR_WRITE(0x2A630338, 0x00000a0a),
+	DDR_WRITE(0x2A63033C, 0x000fffff),
+	DDR_WRITE(0x2A630340, 0x001b003c),	/* FSP2 MR2 and MR1 */
+	DDR_WRITE(0x2A630344, 0x00660010),	/* FSP2 MR11 and MR3 */
+	DDR_WRITE(0x2A630348, 0x0000000e),	/* FSP2 MR13 and MR12 */
+	DDR_WRITE(0x2A63034c, 0x0000000e),	/* FSP2 MR22 and MR14 */
+	DDR_WRITE(0x2A630350, 0x300a120c),
+	DDR_WRITE(0x2A630354, 0x02033524),
+	DDR_WRITE(0x2A630358, 0x03032421),
+	DDR_WRITE(0x2A63035c, 0x00641109),
+	DDR_WRITE(0x2A630360, 0x0000090a),
+	DDR_WRITE(0x2A630364, 0x00000000),
+	DDR_WRITE(0x2A630368, 0x00000000),
+	DDR_WRITE(0x2A63036c, 0x32331414),
+	DDR_WRITE(0x2A630370, 0x00000002),
+	DDR_WRITE(0x2A630374, 0x00052005),
+	DDR_WRITE(0x2A630378, 0x00000a0a),
+	DDR_WRITE(0x2A63037C, 0x000fffff),
+};
+
+/* ------------------- Step3 - Set pin swap ------------------------------ */
+
+static const a600_ddr_step_t a600_ddr_swap[] = {
+	DDR_WRITE(0x2A600160, 0x02105423),	/* CA PHY Pin Swap Register 0 */
+	DDR_WRITE(0x2A600164, 0x0000001e),	/* CA PHY Pin Swap Register 1 */
+	DDR_WRITE(0x2A6001C0, 0x32104756),	/* D PHY Byte0 Swap regsiter 0 */
+	DDR_WRITE(0x2A6001C4, 0x20137654),	/* D PHY Byte0 Swap regsiter 1 */
+	DDR_WRITE(0x2A6001C8, 0x32104756),	/* D PHY Byte0 Swap regsiter 2 */
+	DDR_WRITE(0x2A6001D0, 0x45673021),	/* D PHY Byte1 Swap regsiter 0 */
+	DDR_WRITE(0x2A6001D4, 0x45673102),	/* D PHY Byte1 Swap regsiter 1 */
+	DDR_WRITE(0x2A6001D8, 0x45673021),	/* D PHY Byte1 Swap regsiter 2 */
+	DDR_WRITE(0x2A610160, 0x02105243),	/* CA PHY Pin Swap Register 0 */
+	DDR_WRITE(0x2A610164, 0x0000001b),	/* CA PHY Pin Swap Register 1 */
+	DDR_WRITE(0x2A6101C0, 0x45673021),	/* D PHY Byte0 Swap regsiter 0 */
+	DDR_WRITE(0x2A6101C4, 0x45673102),	/* D PHY Byte0 Swap regsiter 1 */
+	DDR_WRITE(0x2A6101C8, 0x45673021),	/* D PHY Byte0 Swap regsiter 2 */
+	DDR_WRITE(0x2A6101D0, 0x32104756),	/* D PHY Byte1 Swap regsiter 0 */
+	DDR_WRITE(0x2A6101D4, 0x20137654),	/* D PHY Byte1 Swap regsiter 1 */
+	DDR_WRITE(0x2A6101D8, 0x32104756),	/* D PHY Byte1 Swap regsiter 2 */
+};
+
+/* ------------------- Step4 - Set FTDFIW400 control register ------------- */
+
+static const a600_ddr_step_t a600_ddr_dfi[] = {
+	/* Channel A setting */
+	DDR_WRITE(0x2A600004, 0x00031c00),	/* set freq_set_point */
+	DDR_WRITE(0x2A60000c, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A600010, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A600014, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A600020, 0x00120e5c),	/* cbt */
+	DDR_WRITE(0x2A600028, 0x01030014),	/* weye/reye per-bit */
+	DDR_WRITE(0x2A60002C, 0x10000054),	/* weye setting */
+	DDR_WRITE(0x2A600030, 0x55555555),	/* weye external pattern */
+	DDR_WRITE(0x2A600034, 0x5523201c),	/* rvref setting */
+	DDR_WRITE(0x2A60003C, 0x01180100),	/* wvref setting */
+	DDR_WRITE(0x2A600040, 0x00040204),	/* FSP2's DFI timing setting */
+	DDR_WRITE(0x2A600044, 0x00080210),	/* FSP1's DFI timing setting */
+	DDR_WRITE(0x2A600048, 0x0d0b060e),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A60004c, 0x1e1e1e1e),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A600050, 0x25241102),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A600054, 0x858a1e0f),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A600058, 0x40050325),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A60005c, 0xf0100f25),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A600060, 0x20040507),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A600064, 0xa00f100f),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A600068, 0x00002b56),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A60006c, 0x0000ffff),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A600080, 0x0010001b),	/* FSP2's MR3, MR2, RL=20, WL=10 */
+	DDR_WRITE(0x2A600084, 0x0010007f),	/* FSP1's MR3, MR2, RL=36, WL=34 */
+	DDR_WRITE(0x2A600088, 0x00000000),	/* MR13 */
+	DDR_WRITE(0x2A600100, 0x07ff07ff),	/* FSP0's caphdly and csdly */
+	DDR_WRITE(0x2A600238, 0x00002000),	/* FSP2's R0 B0 RVREF */
+	DDR_WRITE(0x2A60023C, 0x00002000),	/* FSP1's R0 B0 RVREF */
+	DDR_WRITE(0x2A600338, 0x00002000),	/* FSP2's R0 B1 RVREF */
+	DDR_WRITE(0x2A60033C, 0x00002000),	/* FSP1's R0 B1 RVREF */
+
+	/* Channel B setting */
+	DDR_WRITE(0x2A610004, 0x00031c00),	/* set freq_set_point */
+	DDR_WRITE(0x2A61000c, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A610010, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A610014, 0x00000000),	/* disable update control */
+	DDR_WRITE(0x2A610020, 0x00120e5c),	/* cbt */
+	DDR_WRITE(0x2A610028, 0x01030014),	/* weye/reye per-bit */
+	DDR_WRITE(0x2A61002C, 0x10000054),	/* weye setting */
+	DDR_WRITE(0x2A610030, 0x55555555),	/* weye external pattern */
+	DDR_WRITE(0x2A610034, 0x5523201c),	/* rvref setting */
+	DDR_WRITE(0x2A61003C, 0x01180100),	/* wvref setting */
+	DDR_WRITE(0x2A610040, 0x00040204),	/* FSP2's DFI timing setting */
+	DDR_WRITE(0x2A610044, 0x00080210),	/* FSP1's DFI timing setting */
+	DDR_WRITE(0x2A610048, 0x0d0b060e),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A61004c, 0x1e1e1e1e),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A610050, 0x25241102),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A610054, 0x858a1e0f),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A610058, 0x40050325),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A61005c, 0xf0100f25),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A610060, 0x20040507),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A610064, 0xa00f100f),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A610068, 0x00002b56),	/* FSP2's timing setting */
+	DDR_WRITE(0x2A61006c, 0x0000ffff),	/* FSP1's timing setting */
+	DDR_WRITE(0x2A610080, 0x0010001b),	/* FSP2's MR3, MR2, RL=20, WL=10 */
+	DDR_WRITE(0x2A610084, 0x0010007f),	/* FSP1's MR3, MR2, RL=36, WL=34 */
+	DDR_WRITE(0x2A610088, 0x00000000),	/* MR13 */
+	DDR_WRITE(0x2A610100, 0x07ff07ff),	/* FSP0's caphdly and csdly */
+	DDR_WRITE(0x2A610238, 0x00002000),	/* FSP2's R0 B0 RVREF */
+	DDR_WRITE(0x2A61023C, 0x00002000),	/* FSP1's R0 B0 RVREF */
+	DDR_WRITE(0x2A610338, 0x00002000),	/* FSP2's R0 B1 RVREF */
+	DDR_WRITE(0x2A61033C, 0x00002000),	/* FSP1's R0 B1 RVREF */
+};
+
+/* ------------------- Step5 - Change to boot frequency and training ------ */
+
+static const a600_ddr_step_t a600_ddr_boot[] = {
+	DDR_WRITE(DDR_CHA_DFI_BOOT, 0x00039c7f),	/* enable wrlvl, reye, wl2nd, weye */
+	DDR_WRITE(DDR_CHB_DFI_BOOT, 0x00039c7f),	/* enable wrlvl, reye, wl2nd, weye */
+
+	/* wait to cha_dfi/chb_dfi boot sequence completed */
+	DDR_POLL(DDR_CHA_DFI_BOOT, DDR_DFI_BOOT_BUSY, 0,
+		 DDR_DFI_BOOT_TIMEOUT_US),
+	DDR_POLL(DDR_CHB_DFI_BOOT, DDR_DFI_BOOT_BUSY, 0,
+		 DDR_DFI_BOOT_TIMEOUT_US),
+};
+
+/* ------------------- Step6 - Trigger DDR initialization and Training ---- */
+
+static const a600_ddr_step_t a600_ddr_train[] = {
+	DDR_WRITE(0x2A620204, 0x00000011),	/* DFI Training Control Register (dfi_auto_init_en) */
+	DDR_WRITE(0x2A630204, 0x00000011),	/* DFI Training Control Register (dfi_auto_init_en) */
+	DDR_WRITE(0x2A620004, 0x00000001),	/* Memory Controller Command Register (Initial command) */
+	DDR_WRITE(0x2A630004, 0x00000001),	/* Memory Controller Command Register (Initial command) */
+
+	/* wait to DDR0/DDR1 init_ok */
+	DDR_POLL(DDR0_CTRL, DDR_CTRL_INIT_OK, DDR_CTRL_INIT_OK,
+		 DDR_INIT_OK_TIMEOUT_US),
+	DDR_POLL(DDR1_CTRL, DDR_CTRL_INIT_OK, DDR_CTRL_INIT_OK,
+		 DDR_INIT_OK_TIMEOUT_US),
+};
+
+static const a600_ddr_seq_t a600_ddr_seq_ctrl = DDR_SEQ("ctrl", a600_ddr_ctrl);
+static const a600_ddr_seq_t a600_ddr_seq_swap = DDR_SEQ("swap", a600_ddr_swap);
+static const a600_ddr_seq_t a600_ddr_seq_dfi = DDR_SEQ("dfi", a600_ddr_dfi);
+static const a600_ddr_seq_t a600_ddr_seq_phy_reset =
+	DDR_SEQ("phy-reset", a600_ddr_phy_reset);
+static const a600_ddr_seq_t a600_ddr_seq_phy_release =
+	DDR_SEQ("phy-release", a600_ddr_phy_release);
+static const a600_ddr_seq_t a600_ddr_seq_boot = DDR_SEQ("boot", a600_ddr_boot);
+static const a600_ddr_seq_t a600_ddr_seq_train =
+	DDR_SEQ("train", a600_ddr_train);
+
+static inline uint64_t a600_ddr_us_to_ticks(uint32_t us)
+{
+	return ((uint64_t)us * read_cntfrq_el0()) / 1000000ULL;
+}
+
+/*******************************************************************************
+ * Run one register sequence, recording how long each step takes. Returns 0 on
+ * success or -ETIMEDOUT if a poll step does not complete in time.
+ ******************************************************************************/
+static int a600_ddr_run_seq(const a600_ddr_seq_t *seq,
+			    a600_ddr_seq_stats_t *stats)
+{
+	const a600_ddr_step_t *step;
+	uint64_t seq_start, start, elapsed, expire;
+	unsigned int i;
+
+	zeromem(stats, sizeof(*stats));
+	seq_start = read_cntpct_el0();
+
+	for (i = 0U; i < seq->num_steps; i++) {
+		step = &seq->steps[i];
+		start = read_cntpct_el0();
+
+		switch (step->op) {
+		case DDR_OP_WRITE:
+			mmio_write_32(step->addr, step->val);
+			break;
+		case DDR_OP_RMW:
+			mmio_clrsetbits_32(step->addr, step->mask, step->val);
+			break;
+		case DDR_OP_POLL:
+			expire = start + a600_ddr_us_to_ticks(step->time_us);
+			while ((mmio_read_32(step->addr) & step->mask) !=
+			       step->val) {
+				if (read_cntpct_el0() > expire) {
+					ERROR("DDR: %s step %u timed out "
+					      "(0x%x & 0x%x != 0x%x)\n",
+					      seq->name, i, step->addr,
+					      step->mask, step->val);
+					return -ETIMEDOUT;
+				}
+			}
+			break;
+		case DDR_OP_DELAY:
+			udelay(step->time_us);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		elapsed = read_cntpct_el0() - start;
+		if (elapsed > stats->slowest) {
+			stats->slowest = elapsed;
+			stats->slowest_step = i;
+		}
+		if ((step->op == DDR_OP_POLL) || (step->op == DDR_OP_DELAY)) {
+			VERBOSE("DDR: %s step %u took %u us\n", seq->name, i,
+				generic_delay_timer_ticks_to_us(elapsed));
+		}
+	}
+
+	stats->total = read_cntpct_el0() - seq_start;
+
+	return 0;
+}
+
+static const a600_ddr_profile_t *a600_ddr_get_profile(unsigned int freq_mhz)
+{
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(a600_ddr_profiles); i++) {
+		if (a600_ddr_profiles[i].freq_mhz == freq_mhz)
+			return &a600_ddr_profiles[i];
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Function that sets up the ddr
+ ******************************************************************************/
+void a600_ddr_init(void)
+{
+	const a600_ddr_profile_t *profile;
+	const a600_ddr_seq_t *seqs[8];
+	a600_ddr_seq_stats_t stats;
+	uint64_t total = 0U;
+	unsigned long long start = boot_instr_now();
+	unsigned int i;
+
+	profile = a600_ddr_get_profile(A600_DDR_FREQ_MHZ);
+	if (profile == NULL) {
+		ERROR("DDR: unsupported data rate %u MHz\n",
+		      A600_DDR_FREQ_MHZ);
+		panic();
+	}
+
+	seqs[0] = &a600_ddr_seq_phy_reset;
+	seqs[1] = &profile->pll;
+	seqs[2] = &a600_ddr_seq_phy_release;
+	seqs[3] = &a600_ddr_seq_ctrl;
+	seqs[4] = &a600_ddr_seq_swap;
+	seqs[5] = &a600_ddr_seq_dfi;
+	seqs[6] = &a600_ddr_seq_boot;
+	seqs[7] = &a600_ddr_seq_train;
+
+	for (i = 0U; i < ARRAY_SIZE(seqs); i++) {
+		if (a600_ddr_run_seq(seqs[i], &stats) != 0)
+			panic();
+
+		VERBOSE("DDR: %s: %u us (slowest step %u: %u us)\n",
+			seqs[i]->name,
+			generic_delay_timer_ticks_to_us(stats.total),
+			stats.slowest_step,
+			generic_delay_timer_ticks_to_us(stats.slowest));
+		total += stats.total;
+	}
+
+	INFO("DDR: initialised at %u MHz in %u us\n", profile->freq_mhz,
+	     generic_delay_timer_ticks_to_us(total));
+
+	boot_instr_add(BOOT_INSTR_DDR_INIT, start);
+}
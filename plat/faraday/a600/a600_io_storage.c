@@ -41,8 +41,8 @@ static uintptr_t fip_dev_handle;
 static uintptr_t memmap_dev_handle;
 
 static const io_block_spec_t fip_block_spec = {
-	.offset = 0x10010000,
-	.length = 0x00100000
+	.offset = PLAT_A600_FIP_BASE,
+	.length = PLAT_A600_FIP_MAX_SIZE
 };
 
 static const io_uuid_spec_t bl2_uuid_spec = {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,12 +10,19 @@
 
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/arm/gicv2.h>
 #include <drivers/console.h>
 #include <lib/mmio.h>
 #include <lib/psci/psci.h>
+#include <lib/utils_def.h>
 #include <plat/common/platform.h>
 
 #include "a600_hw.h"
+#include "a600_private.h"
+
+/* Macros to read the a600 power domain state */
+#define A600_CORE_PWR_STATE(state)	(state)->pwr_domain_state[MPIDR_AFFLVL0]
+#define A600_CLUSTER_PWR_STATE(state)	(state)->pwr_domain_state[MPIDR_AFFLVL1]
 
 /* Make composite power state parameter till power level 0 */
 #if PSCI_EXTENDED_STATE_ID
@@ -39,9 +46,8 @@
 
 /*
  *  The table storing the valid idle power states. Ensure that the
- *  array entries are populated in ascending order of state-id to
- *  enable us to use binary search during power state validation.
- *  The table must be terminated by a NULL entry.
+ *  array entries are populated in ascending order of power state
+ *  value, as a600_validate_power_state() uses a binary search.
  */
 static const unsigned int a600_pm_idle_states[] = {
 	/* State-id - 0x01 */
@@ -53,7 +59,6 @@ static const unsigned int a600_pm_idle_states[] = {
 	/* State-id - 0x22 */
 	a600_make_pwrstate_lvl1(PLAT_LOCAL_STATE_OFF, PLAT_LOCAL_STATE_OFF,
 				MPIDR_AFFLVL1, PSTATE_TYPE_POWERDOWN),
-	0,
 };
 
 /*******************************************************************************
@@ -64,23 +69,27 @@ static int a600_validate_power_state(unsigned int power_state,
 				     psci_power_state_t *req_state)
 {
 	unsigned int state_id;
+	unsigned int lo = 0U;
+	unsigned int hi = ARRAY_SIZE(a600_pm_idle_states);
+	unsigned int mid;
 	int i;
 
 	assert(req_state != 0);
 
-	/*
-	 *  Currently we are using a linear search for finding the matching
-	 *  entry in the idle power state array. This can be made a binary
-	 *  search if the number of entries justify the additional complexity.
-	 */
-	for (i = 0; a600_pm_idle_states[i] != 0; i++) {
-		if (power_state == a600_pm_idle_states[i]) {
+	/* Look for the matching entry in the idle power state array */
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (power_state == a600_pm_idle_states[mid]) {
 			break;
+		} else if (power_state > a600_pm_idle_states[mid]) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
 		}
 	}
 
 	/* Return error if entry not found in the idle state array */
-	if (!a600_pm_idle_states[i]) {
+	if (lo >= hi) {
 		return PSCI_E_INVALID_PARAMS;
 	}
 
@@ -102,8 +111,6 @@ static int a600_validate_power_state(unsigned int power_state,
  ******************************************************************************/
 static void a600_cpu_standby(plat_local_state_t cpu_state)
 {
-	INFO("a600: PSCI_CPU_STANDBY\n");
-
 	assert(cpu_state == PLAT_LOCAL_STATE_RET);
 
 	/*
@@ -139,6 +146,74 @@ static int a600_pwr_domain_on(u_register_t mpidr)
 	return rc;
 }
 
+/*******************************************************************************
+ * Platform handler called when a power domain is about to be turned off. The
+ * target_state encodes the power state that each level should transition to.
+ ******************************************************************************/
+static void a600_pwr_domain_off(const psci_power_state_t *target_state)
+{
+	uint64_t *hold_base = (uint64_t *)PLAT_A600_TM_HOLD_BASE;
+
+	assert(A600_CORE_PWR_STATE(target_state) == PLAT_LOCAL_STATE_OFF);
+
+	gicv2_cpuif_disable();
+
+	/*
+	 * Close the hold pen before PSCI marks this cpu as off. Once that is
+	 * done, a600_pwr_domain_on() may release the cpu at any time, even
+	 * before it reaches a600_pwr_down_wfi().
+	 */
+	hold_base[plat_my_core_pos()] = PLAT_A600_TM_HOLD_STATE_WAIT;
+	dsb();
+
+	/*
+	 * There is no cluster power controller, PSCI has already flushed the
+	 * caches so there is nothing else to do at the cluster level.
+	 */
+}
+
+/*******************************************************************************
+ * Platform handler called when a power domain is about to be suspended. The
+ * target_state encodes the power state that each level should transition to.
+ ******************************************************************************/
+static void a600_pwr_domain_suspend(const psci_power_state_t *target_state)
+{
+	uint64_t *hold_base = (uint64_t *)PLAT_A600_TM_HOLD_BASE;
+
+	assert(A600_CORE_PWR_STATE(target_state) == PLAT_LOCAL_STATE_OFF);
+
+	/*
+	 * The GIC CPU interface is left enabled: without a power controller the
+	 * only wake-up source is an interrupt signalled to the cpu in WFI.
+	 *
+	 * Leave the hold pen open so that a600_pwr_down_wfi() knows that the
+	 * cpu must resume at the warm boot entrypoint as soon as it wakes up.
+	 */
+	hold_base[plat_my_core_pos()] = PLAT_A600_TM_HOLD_STATE_GO;
+	dsb();
+}
+
+/*******************************************************************************
+ * Platform handler called to enter a power down state. There is no power
+ * controller, so the cpu is emulating power down: it waits with the MMU off,
+ * in WFI if it is suspended or in the hold pen if it is off, and then goes
+ * through the warm boot entrypoint like a cpu coming out of reset.
+ ******************************************************************************/
+static void __dead2 a600_pwr_down_wfi(const psci_power_state_t *target_state)
+{
+	uint64_t *hold_base = (uint64_t *)PLAT_A600_TM_HOLD_BASE;
+
+	/* The warm boot entrypoint expects the MMU to be off */
+	disable_mmu_el3();
+
+	if (hold_base[plat_my_core_pos()] == PLAT_A600_TM_HOLD_STATE_GO) {
+		dsbsy();
+		wfi();
+	}
+
+	a600_hold_pen();
+}
+
 /*******************************************************************************
  * Platform handler called when a power domain has just been powered on after
  * being turned off earlier. The target_state encodes the low power state that
@@ -146,10 +221,24 @@ static int a600_pwr_domain_on(u_register_t mpidr)
  ******************************************************************************/
 static void a600_pwr_domain_on_finish(const psci_power_state_t *target_state)
 {
-	INFO("a600: PSCI_PWR_DOMAIN_ON_FINISH\n");
+	assert(A600_CORE_PWR_STATE(target_state) == PLAT_LOCAL_STATE_OFF);
+
+	gicv2_pcpu_distif_init();
+	gicv2_cpuif_enable();
+}
 
-	assert(target_state->pwr_domain_state[MPIDR_AFFLVL0] ==
-					PLAT_LOCAL_STATE_OFF);
+/*******************************************************************************
+ * Platform handler called when a power domain has just been powered on after
+ * having been suspended earlier. The target_state encodes the low power state
+ * that each level has woken up from.
+ ******************************************************************************/
+static void a600_pwr_domain_suspend_finish(const psci_power_state_t *target_state)
+{
+	/*
+	 * The cpu and cluster were never really powered down, so the GIC and
+	 * cluster state are intact and there is nothing to restore.
+	 */
+	assert(A600_CORE_PWR_STATE(target_state) == PLAT_LOCAL_STATE_OFF);
 }
 
 /*******************************************************************************
@@ -213,8 +302,12 @@ static void __dead2 a600_system_off(void)
  ******************************************************************************/
 static const plat_psci_ops_t plat_a600_psci_pm_ops = {
 	.cpu_standby = a600_cpu_standby,
+	.pwr_domain_off = a600_pwr_domain_off,
 	.pwr_domain_on = a600_pwr_domain_on,
 	.pwr_domain_on_finish = a600_pwr_domain_on_finish,
+	.pwr_domain_pwr_down_wfi = a600_pwr_down_wfi,
+	.pwr_domain_suspend = a600_pwr_domain_suspend,
+	.pwr_domain_suspend_finish = a600_pwr_domain_suspend_finish,
 	.system_off = a600_system_off,
 	.system_reset = a600_system_reset,
 	.validate_power_state = a600_validate_power_state,
@@ -7,6 +7,7 @@
 #ifndef A600_PRIVATE_H
 #define A600_PRIVATE_H
 
+#include <cdefs.h>
 #include <stdint.h>
 
 /*******************************************************************************
@@ -16,6 +17,7 @@
 /* Utility functions */
 void a600_platform_init(void);
 void a600_console_init(void);
+void a600_console_log_init(void);
 void a600_ddr_init(void);
 void a600_tzc_init(void);
 void a600_setup_page_tables(uintptr_t total_base, size_t total_size,
@@ -28,6 +30,7 @@ void a600_setup_page_tables(uintptr_t total_base, size_t total_size,
 
 /* Optional functions required in the Raspberry Pi 3 port */
 unsigned int plat_a600_calc_core_pos(u_register_t mpidr);
+void __dead2 a600_hold_pen(void);
 
 /* BL2 utility functions */
 uint32_t a600_get_spsr_for_bl32_entry(void);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -71,6 +71,10 @@
 
 #define SEC_DRAM0_BASE                  ULL(0x80000000)
 #define SEC_DRAM0_SIZE                  ULL(0x00800000)
+
+/* Secure DRAM at the top of the address space, holds BL31 and BL32 */
+#define SEC_DRAM1_BASE                  ULL(0xFF800000)
+#define SEC_DRAM1_SIZE                  ULL(0x00800000)
 /* End of reserved memory */
 
 #define NS_DRAM0_BASE                   ULL(0x80800000)
@@ -82,6 +86,12 @@
 #define PLAT_A600_NS_IMAGE_OFFSET       NS_DRAM0_BASE
 #define PLAT_A600_NS_IMAGE_MAX_SIZE     NS_DRAM0_SIZE
 
+/*
+ * Memory-mapped flash window holding the FIP.
+ */
+#define PLAT_A600_FIP_BASE              ULL(0x10010000)
+#define PLAT_A600_FIP_MAX_SIZE          ULL(0x00100000)
+
 /*
  * I/O registers.
  */
@@ -210,8 +220,8 @@
 #define PLAT_PHY_ADDR_SPACE_SIZE        (ULL(1) << 32)
 #define PLAT_VIRT_ADDR_SPACE_SIZE       (ULL(1) << 32)
 
-#define MAX_MMAP_REGIONS                8
-#define MAX_XLAT_TABLES                 4
+#define MAX_MMAP_REGIONS                12
+#define MAX_XLAT_TABLES                 6
 
 #define MAX_IO_DEVICES                  U(3)
 #define MAX_IO_HANDLES                  U(4)
@@ -230,6 +240,31 @@
 #define PLAT_A600_UART_CLK_IN_HZ        A600_UART_CLK_IN_HZ
 #define PLAT_A600_UART_BAUDRATE         ULL(115200)
 
+/*
+ * Log region of the buffered console (A600_CONSOLE_LOG=1), at the top of the
+ * non-secure DRAM so that the normal world can read it. It holds a ring of
+ * PLAT_A600_CONSOLE_LOG_RING_SIZE characters per CPU.
+ */
+#define PLAT_A600_CONSOLE_LOG_SIZE      ULL(0x10000)
+#define PLAT_A600_CONSOLE_LOG_BASE      (NS_DRAM0_BASE + NS_DRAM0_SIZE - \
+                                         PLAT_A600_CONSOLE_LOG_SIZE)
+#define PLAT_A600_CONSOLE_LOG_RING_SIZE U(0x2000)
+
+/*
+ * EL3 trace region (ENABLE_EL3_TRACE=1), just below the console log region.
+ * It holds a ring of PLAT_EL3_TRACE_RING_SIZE events per CPU.
+ */
+#define PLAT_EL3_TRACE_SIZE             ULL(0x9000)
+#define PLAT_EL3_TRACE_BASE             (PLAT_A600_CONSOLE_LOG_BASE - \
+                                         PLAT_EL3_TRACE_SIZE)
+#define PLAT_EL3_TRACE_RING_SIZE        U(256)
+
+/*
+ * Preloaded device tree (A600_PRELOADED_DTB_BASE). BL31 maps this many bytes
+ * of it, and its fixups never grow it past them.
+ */
+#define PLAT_A600_DTB_MAX_SIZE          ULL(0x10000)
+
 /*
  * System counter
  */
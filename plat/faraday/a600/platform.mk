@@ -27,6 +27,7 @@ BL2_SOURCES		+=	lib/cpus/aarch64/cortex_a53.S		\
 				plat/faraday/a600/aarch64/plat_helpers.S	\
 				plat/faraday/a600/aarch64/a600_bl2_mem_params_desc.c \
 				plat/faraday/a600/a600_bl2_setup.c		\
+				plat/faraday/a600/a600_ddr.c			\
 				plat/faraday/a600/a600_image_load.c		\
 				plat/faraday/a600/a600_io_storage.c
 
@@ -92,6 +93,12 @@ BL2_AT_EL3				:= 1
 # Reset to BL31 isn't supported
 RESET_TO_BL31			:= 0
 
+# Use the optimised AArch64 memcpy/memmove/memset/memcmp
+USE_ASM_MEMFUNCS		:= 1
+
+# The FIP is memory-mapped: use certificates in place instead of copying them
+LOAD_IMAGE_ZERO_COPY		:= 1
+
 # Have different sections for code and rodata
 SEPARATE_CODE_AND_RODATA	:= 1
 
@@ -104,6 +111,9 @@ USE_COHERENT_MEM		:= 0
 # This platform is single-cluster and does not require coherency setup.
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
 
+# Let the TLBs hold runs of contiguous pages and blocks in a single entry
+XLAT_TABLES_CONT_HINT		:= 1
+
 # Platform build flags
 # --------------------
 
@@ -117,6 +127,16 @@ A600_DIRECT_LINUX_BOOT		:= 0
 # Any other value means the default UART will be used.
 A600_RUNTIME_UART		:= -1
 
+# Buffer the console of BL31 in per-CPU rings in non-secure DRAM, so that
+# printing doesn't wait for the UART and the normal world can read the log.
+A600_CONSOLE_LOG		:= 0
+
+# DDR data rate in MHz. Must match one of the profiles in a600_ddr.c.
+A600_DDR_FREQ_MHZ		:= 2133
+ifeq ($(filter ${A600_DDR_FREQ_MHZ},400 800 1066 1600 1866 2133),)
+  $(error "Unsupported A600_DDR_FREQ_MHZ value")
+endif
+
 # BL32 location
 A600_BL32_RAM_LOCATION	:= tdram
 ifeq (${A600_BL32_RAM_LOCATION}, tsram)
@@ -132,7 +152,9 @@ endif
 
 $(eval $(call add_define,A600_BL32_RAM_LOCATION_ID))
 $(eval $(call add_define,A600_BL33_IN_AARCH32))
+$(eval $(call add_define,A600_CONSOLE_LOG))
 $(eval $(call add_define,A600_DIRECT_LINUX_BOOT))
+$(eval $(call add_define,A600_DDR_FREQ_MHZ))
 ifdef A600_PRELOADED_DTB_BASE
 $(eval $(call add_define,A600_PRELOADED_DTB_BASE))
 endif
@@ -147,6 +169,17 @@ ifneq (${A600_DIRECT_LINUX_BOOT}, 0)
   endif
 endif
 
+$(eval $(call assert_boolean,A600_CONSOLE_LOG))
+
+ifeq (${A600_CONSOLE_LOG},1)
+BL31_SOURCES		+=	drivers/console/buffered_console.c
+endif
+
+ifeq (${ENABLE_PMF},1)
+BL31_SOURCES		+=	lib/pmf/pmf_smc.c			\
+				plat/faraday/a600/a600_sip_svc.c
+endif
+
 ifneq (${RESET_TO_BL31}, 0)
   $(error Error: a600 needs RESET_TO_BL31=0)
 endif
@@ -176,6 +209,9 @@ endif
 
 ifneq (${TRUSTED_BOARD_BOOT},0)
 
+    # The Cortex-A53 cores implement the Cryptographic Extension
+    TF_MBEDTLS_USE_SHA256_CE	:=	1
+
     include drivers/auth/mbedtls/mbedtls_crypto.mk
     include drivers/auth/mbedtls/mbedtls_x509.mk
 
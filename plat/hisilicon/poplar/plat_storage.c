@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -40,10 +40,14 @@ static const io_block_dev_spec_t emmc_dev_spec = {
 		.length	= POPLAR_EMMC_DATA_SIZE,
 	},
 	.ops		= {
-		.read	= mmc_read_blocks,
-		.write	= mmc_write_blocks,
+		.read		= mmc_read_blocks,
+		.write		= mmc_write_blocks,
+		.read_start	= mmc_read_blocks_start,
+		.read_wait	= mmc_read_blocks_wait,
 	},
 	.block_size	= MMC_BLOCK_SIZE,
+	/* The IDMAC of the eMMC controller can reach all of DDR */
+	.flags		= IO_BLOCK_DIRECT_READ,
 };
 #else
 static const io_dev_connector_t *mmap_dev_con;
@@ -22,9 +22,12 @@ PLAT_BL_COMMON_SOURCES	:=	\
 			plat/intel/soc/stratix10/aarch64/platform_common.c \
 			plat/intel/soc/stratix10/aarch64/plat_helpers.S \
 
+include lib/zlib/zlib.mk
+
 BL2_SOURCES     +=	\
 		drivers/partition/partition.c				\
 		drivers/partition/gpt.c					\
+		$(ZLIB_PATH)/crc32.c					\
 		drivers/arm/pl061/pl061_gpio.c				\
 		drivers/mmc/mmc.c					\
 		drivers/synopsys/emmc/dw_mmc.c				\
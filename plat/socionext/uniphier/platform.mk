@@ -108,6 +108,12 @@ BL2_SOURCES		+=	common/image_decompress.c		\
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
+# decompress the images while they are read, instead of after reading them
+# whole into a temporary buffer
+ifeq (${FIP_GZIP_STREAM},1)
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP_STREAM))
+endif
+
 # compress all images loaded by BL2
 SCP_BL2_PRE_TOOL_FILTER	:= GZIP
 BL31_PRE_TOOL_FILTER	:= GZIP
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -116,9 +116,22 @@ bl_params_t *plat_get_next_bl_params(void)
 	return get_next_bl_params_from_mem_params_desc();
 }
 
+#ifdef UNIPHIER_DECOMPRESS_GZIP_STREAM
+static const decompressor_stream_t uniphier_gunzip_stream = {
+	.start = gunzip_stream_start,
+	.update = gunzip_stream_update,
+	.finish = gunzip_stream_finish,
+};
+#endif
+
 void bl2_plat_preload_setup(void)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#if defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
+	image_decompress_stream_init(UNIPHIER_IMAGE_BUF_BASE,
+				     IMAGE_DECOMPRESS_STREAM_CHUNK_SIZE +
+				     GUNZIP_STREAM_WORK_SIZE,
+				     &uniphier_gunzip_stream);
+#elif defined(UNIPHIER_DECOMPRESS_GZIP)
 	image_decompress_init(UNIPHIER_IMAGE_BUF_BASE,
 			      UNIPHIER_IMAGE_BUF_SIZE,
 			      gunzip);
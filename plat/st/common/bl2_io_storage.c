@@ -49,6 +49,8 @@ static const io_block_dev_spec_t mmc_block_dev_spec = {
 		.write = NULL,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	/* The SDMMC2 driver falls back to polling for non-DMA buffers */
+	.flags = IO_BLOCK_DIRECT_READ,
 };
 
 static uintptr_t storage_dev_handle;
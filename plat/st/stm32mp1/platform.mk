@@ -73,11 +73,14 @@ BL2_SOURCES		+=	drivers/io/io_block.c					\
 				plat/st/common/bl2_io_storage.c				\
 				plat/st/stm32mp1/bl2_plat_setup.c
 
+include lib/zlib/zlib.mk
+
 BL2_SOURCES		+=	drivers/mmc/mmc.c					\
 				drivers/partition/gpt.c					\
 				drivers/partition/partition.c				\
 				drivers/st/io/io_mmc.c					\
-				drivers/st/mmc/stm32_sdmmc2.c
+				drivers/st/mmc/stm32_sdmmc2.c				\
+				$(ZLIB_PATH)/crc32.c
 
 BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr.c				\
 				drivers/st/ddr/stm32mp1_ram.c
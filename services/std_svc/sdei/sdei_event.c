@@ -1,11 +1,14 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
 
+#include <drivers/arm/gic_common.h>
 #include <lib/utils.h>
 
 #include "sdei_private.h"
@@ -51,6 +54,70 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/*
+ * Indices of the mappings bound to each interrupt, plus one, or 0 if no mapping
+ * is bound to the interrupt. Private mappings can only be bound to SGIs and
+ * PPIs, and shared mappings to SPIs.
+ */
+static uint16_t private_intr_index[TOTAL_PCPU_INTR_NUM];
+static uint16_t shared_intr_index[TOTAL_SPI_INTR_NUM];
+
+static uint16_t *intr_index_entry(unsigned int intr_num, bool shared)
+{
+	if (shared) {
+		if ((intr_num < MIN_SPI_ID) || (intr_num > MAX_SPI_ID))
+			return NULL;
+
+		return &shared_intr_index[intr_num - MIN_SPI_ID];
+	}
+
+	if (intr_num >= MIN_SPI_ID)
+		return NULL;
+
+	return &private_intr_index[intr_num];
+}
+
+/*
+ * Record that a mapping is now bound to its interrupt, or that it was unbound
+ * from interrupt 'intr_num'. The caller must hold the lock of the mapping.
+ */
+void sdei_intr_index_update(sdei_ev_map_t *map, unsigned int intr_num)
+{
+	const sdei_mapping_t *mapping;
+	uint16_t *entry, idx;
+
+	entry = intr_index_entry(intr_num, is_event_shared(map));
+	if (entry == NULL)
+		return;
+
+	mapping = is_event_shared(map) ? SDEI_SHARED_MAPPING() :
+		SDEI_PRIVATE_MAPPING();
+	idx = (uint16_t) (MAP_OFF(map, mapping) + 1);
+
+	if (map->intr == intr_num)
+		*entry = idx;
+	else if (*entry == idx)
+		*entry = 0U;
+}
+
+/* Index the mappings that are bound to an interrupt at boot time */
+void sdei_intr_index_init(void)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j;
+
+	for_each_mapping_type(i, mapping) {
+		assert(mapping->num_maps < UINT16_MAX);
+
+		iterate_mapping(mapping, j, map) {
+			/* Event 0 is the only unbound mapping with an SGI */
+			if (is_map_bound(map) || (map->ev_num == SDEI_EVENT_0))
+				sdei_intr_index_update(map, map->intr);
+		}
+	}
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -59,17 +126,50 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
+	const uint16_t *entry;
 	unsigned int i;
 
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Free dynamic mappings have their interrupt set as SDEI_DYN_IRQ and
+	 * aren't indexed. Looking for one only happens on bind, so a linear
+	 * search is fine.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
-	iterate_mapping(mapping, i, map) {
-		if (map->intr == intr_num)
-			return map;
+	if (intr_num == SDEI_DYN_IRQ) {
+		iterate_mapping(mapping, i, map) {
+			if (map->intr == intr_num)
+				return map;
+		}
+
+		return NULL;
+	}
+
+	entry = intr_index_entry(intr_num, shared);
+	if ((entry == NULL) || (*entry == 0U))
+		return NULL;
+
+	map = &mapping->map[*entry - 1U];
+
+	/* The mapping may have been released since the index was read */
+	return (map->intr == intr_num) ? map : NULL;
+}
+
+/* Binary search of an event number in a mapping sorted by event number */
+static sdei_ev_map_t *search_mapping(const sdei_mapping_t *mapping, int ev_num)
+{
+	size_t low = 0U, high = mapping->num_maps;
+	size_t mid;
+
+	while (low < high) {
+		mid = low + ((high - low) / 2U);
+		if (mapping->map[mid].ev_num == ev_num)
+			return &mapping->map[mid];
+
+		if (mapping->map[mid].ev_num < ev_num)
+			low = mid + 1U;
+		else
+			high = mid;
 	}
 
 	return NULL;
@@ -83,18 +183,16 @@ sdei_ev_map_t *find_event_map(int ev_num)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i, j;
+	unsigned int i;
 
 	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
+	 * The mappings are required to be sorted by event number, which is
+	 * checked by sdei_class_init(), so they can be binary searched.
 	 */
 	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
-			if (map->ev_num == ev_num)
-				return map;
-		}
+		map = search_mapping(mapping, ev_num);
+		if (map != NULL)
+			return map;
 	}
 
 	return NULL;
@@ -229,6 +229,9 @@ void sdei_init(void)
 	sdei_class_init(SDEI_CRITICAL);
 	sdei_class_init(SDEI_NORMAL);
 
+	/* Index the mappings by interrupt, for the interrupt handler */
+	sdei_intr_index_init();
+
 	/* Register priority level handlers */
 	ehf_register_priority_handler(PLAT_SDEI_CRITICAL_PRI,
 			sdei_intr_handler);
@@ -745,6 +748,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			sdei_intr_index_update(map, intr_num);
 			retry = false;
 		}
 		sdei_map_unlock(map);
@@ -757,6 +761,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 static int sdei_interrupt_release(int ev_num)
 {
 	int ret = 0;
+	unsigned int intr_num;
 	sdei_ev_map_t *map;
 	sdei_entry_t *se;
 
@@ -802,8 +807,10 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		intr_num = map->intr;
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
+		sdei_intr_index_update(map, intr_num);
 	} else {
 		SDEI_LOG("Error release bound:%d cnt:%d\n", is_map_bound(map),
 				map->reg_count);
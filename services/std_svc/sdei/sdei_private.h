@@ -230,6 +230,8 @@ extern sdei_entry_t sdei_shared_event_table[];
 
 void init_sdei_state(void);
 
+void sdei_intr_index_init(void);
+void sdei_intr_index_update(sdei_ev_map_t *map, unsigned int intr_num);
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
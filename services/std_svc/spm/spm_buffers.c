@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stddef.h>
+
 #include <arch_helpers.h>
 #include <lib/spinlock.h>
 #include <lib/utils_def.h>
@@ -12,12 +14,29 @@
 #include "./spm_private.h"
 
 /*******************************************************************************
- * Secure Service response global array. All the responses to the requests done
- * to the Secure Partition are stored here. They are removed from the array as
+ * Secure Service response global table. All the responses to the requests done
+ * to the Secure Partition are stored here. They are removed from the table as
  * soon as their value is read.
+ *
+ * The table is open addressed: a response is stored in the first free slot
+ * found by linear probing from its home slot, token % PLAT_SPM_RESPONSES_MAX.
+ * Tokens are handed out sequentially, so the responses in flight usually sit
+ * in their home slot.
+ *
+ * There is no global lock:
+ * - All adds and gets of the tokens of a home slot are serialized by the lock
+ *   of that home, so that a token can't be added twice or read twice.
+ * - A slot is claimed with spin_trylock() on its 'used' lock, which works as
+ *   an atomic busy flag, and freed by releasing it. Claiming a slot never
+ *   waits, so holding a home lock while probing can't deadlock.
+ * - Each home remembers the longest probe distance of any of its responses,
+ *   so lookups stop there instead of scanning the whole table.
+ *
+ * tools/spm_buffers_test runs this table on the host with several threads.
  ******************************************************************************/
 struct sprt_response {
-	int is_valid;
+	spinlock_t used;
+	volatile int is_valid;
 	uint32_t token;
 	uint16_t client_id, handle;
 	u_register_t x1, x2, x3;
@@ -25,47 +44,87 @@ struct sprt_response {
 
 static struct sprt_response responses[PLAT_SPM_RESPONSES_MAX];
 
-static spinlock_t responses_lock;
+static spinlock_t home_lock[PLAT_SPM_RESPONSES_MAX];
+static unsigned int home_probe_max[PLAT_SPM_RESPONSES_MAX];
+
+static unsigned int response_home(uint32_t token)
+{
+	return token % PLAT_SPM_RESPONSES_MAX;
+}
+
+/*
+ * Find the response with a given token. The lock of the home of the token must
+ * be held. Returns NULL if it isn't in the table.
+ */
+static struct sprt_response *response_find(uint32_t token)
+{
+	unsigned int home = response_home(token);
+
+	for (unsigned int i = 0U; i <= home_probe_max[home]; i++) {
+		struct sprt_response *resp =
+			&responses[(home + i) % PLAT_SPM_RESPONSES_MAX];
+
+		if (resp->is_valid == 0) {
+			continue;
+		}
+
+		/* Read the token only after is_valid */
+		dmbish();
+
+		/* Responses of other homes never have the same token */
+		if (resp->token == token) {
+			return resp;
+		}
+	}
+
+	return NULL;
+}
 
 /* Add response to the global response buffer. Returns 0 on success else -1. */
 int spm_response_add(uint16_t client_id, uint16_t handle, uint32_t token,
 		     u_register_t x1, u_register_t x2, u_register_t x3)
 {
-	spin_lock(&responses_lock);
+	unsigned int home = response_home(token);
+	int rc = -1;
 
-	/* Make sure that there isn't any other response with the same token. */
-	for (unsigned int i = 0U; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
+	spin_lock(&home_lock[home]);
 
-		if ((resp->is_valid == 1) && (resp->token == token)) {
-			return -1;
-		}
+	/* Make sure that there isn't any other response with the same token. */
+	if (response_find(token) != NULL) {
+		spin_unlock(&home_lock[home]);
+		return -1;
 	}
 
-	for (unsigned int i = 0U; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
+	for (unsigned int i = 0U; i < PLAT_SPM_RESPONSES_MAX; i++) {
+		struct sprt_response *resp =
+			&responses[(home + i) % PLAT_SPM_RESPONSES_MAX];
 
-		if (resp->is_valid == 0) {
-			resp->token = token;
-			resp->client_id = client_id;
-			resp->handle = handle;
-			resp->x1 = x1;
-			resp->x2 = x2;
-			resp->x3 = x3;
+		if (spin_trylock(&resp->used) == 0) {
+			continue;
+		}
 
-			dmbish();
+		resp->token = token;
+		resp->client_id = client_id;
+		resp->handle = handle;
+		resp->x1 = x1;
+		resp->x2 = x2;
+		resp->x3 = x3;
 
-			resp->is_valid = 1;
+		dmbish();
 
-			spin_unlock(&responses_lock);
+		resp->is_valid = 1;
 
-			return 0;
+		if (i > home_probe_max[home]) {
+			home_probe_max[home] = i;
 		}
+
+		rc = 0;
+		break;
 	}
 
-	spin_unlock(&responses_lock);
+	spin_unlock(&home_lock[home]);
 
-	return -1;
+	return rc;
 }
 
 /*
@@ -75,22 +134,17 @@ int spm_response_add(uint16_t client_id, uint16_t handle, uint32_t token,
 int spm_response_get(uint16_t client_id, uint16_t handle, uint32_t token,
 		     u_register_t *x1, u_register_t *x2, u_register_t *x3)
 {
-	spin_lock(&responses_lock);
+	unsigned int home = response_home(token);
+	struct sprt_response *resp;
+	int rc = -1;
 
-	for (unsigned int i = 0U; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
+	spin_lock(&home_lock[home]);
 
-		/* Ignore invalid entries */
-		if (resp->is_valid == 0) {
-			continue;
-		}
-
-		/* Make sure that all the information matches the stored one */
-		if ((resp->token != token) || (resp->client_id != client_id) ||
-		    (resp->handle != handle)) {
-			continue;
-		}
+	resp = response_find(token);
 
+	/* Make sure that all the information matches the stored one */
+	if ((resp != NULL) && (resp->client_id == client_id) &&
+	    (resp->handle == handle)) {
 		*x1 = resp->x1;
 		*x2 = resp->x2;
 		*x3 = resp->x3;
@@ -99,12 +153,13 @@ int spm_response_get(uint16_t client_id, uint16_t handle, uint32_t token,
 
 		resp->is_valid = 0;
 
-		spin_unlock(&responses_lock);
+		/* Free the slot */
+		spin_unlock(&resp->used);
 
-		return 0;
+		rc = 0;
 	}
 
-	spin_unlock(&responses_lock);
+	spin_unlock(&home_lock[home]);
 
-	return -1;
+	return rc;
 }
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host contention test of the bakery locks of bakery_lock_normal.c, built
+ * with and without USE_QUEUED_BAKERY_LOCKS.
+ *
+ * Each thread plays a CPU. It takes one of two locks, or both nested, and
+ * checks in the critical section that no other thread holds the lock and that
+ * the counter of the lock isn't updated concurrently. In a share of the
+ * iterations a thread runs as if its data cache were disabled, which makes it
+ * use the bakery instead of the queue when the queue is built in. At the end,
+ * the counters must add up to the number of times each lock was taken.
+ *
+ * Bakery tickets have 15 bits and only go back to zero once no CPU contends for
+ * the lock. In the firmware, contention comes in short bursts. On a host that
+ * runs more threads than it has CPUs, it never stops, so the threads meet at a
+ * barrier every ROUND_ITERATIONS iterations to let the tickets go back to zero.
+ *
+ * The host is coherent and the cache maintenance operations are left out, so
+ * the time per lock only compares the algorithms, not what they cost on
+ * hardware.
+ *
+ * Usage: bakery_lock_test [threads [iterations [uncached percent]]]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../lib/locks/bakery/bakery_lock_normal.c"
+
+#define DEFAULT_THREADS		4U
+#define DEFAULT_ITERATIONS	200000U
+#define DEFAULT_UNCACHED	25U
+
+#define NUM_LOCKS		2U
+#define ROUND_ITERATIONS	1000U
+
+/*
+ * What the linker script provides in the firmware: the lock data of CPU n is
+ * at n * PLAT_PERCPU_BAKERY_LOCK_SIZE in the bakery lock section, and each lock
+ * has a queue.
+ */
+char __PERCPU_BAKERY_LOCK_START__[PLATFORM_CORE_COUNT *
+				  PLAT_PERCPU_BAKERY_LOCK_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+#if USE_QUEUED_BAKERY_LOCKS
+char __BAKERY_QUEUE_START__[NUM_LOCKS * BAKERY_QUEUE_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+uintptr_t bakery_queue_swap(volatile uintptr_t *tail, uintptr_t node)
+{
+	return __atomic_exchange_n(tail, node, __ATOMIC_ACQ_REL);
+}
+#endif
+
+typedef struct worker {
+	pthread_t thread;
+	unsigned int core_pos;
+	unsigned int seed;
+	unsigned long taken[NUM_LOCKS];
+	unsigned long errors;
+} worker_t;
+
+/* What each lock protects */
+static struct {
+	volatile int owner;
+	volatile unsigned long count;
+} shared[NUM_LOCKS];
+
+static unsigned int threads = DEFAULT_THREADS;
+static unsigned int iterations = DEFAULT_ITERATIONS;
+static unsigned int uncached = DEFAULT_UNCACHED;
+static pthread_barrier_t round_barrier;
+
+static __thread unsigned int my_core_pos;
+__thread u_register_t test_sctlr_el3;
+
+unsigned int plat_my_core_pos(void)
+{
+	return my_core_pos;
+}
+
+static bakery_lock_t *get_lock(unsigned int l)
+{
+	return (bakery_lock_t *)__PERCPU_BAKERY_LOCK_START__ + l;
+}
+
+static void lock(worker_t *w, unsigned int l)
+{
+	unsigned long count;
+
+	bakery_lock_get(get_lock(l));
+
+	if (shared[l].owner != -1) {
+		fprintf(stderr, "CPU %u: lock %u held by CPU %d\n",
+			w->core_pos, l, shared[l].owner);
+		w->errors++;
+	}
+	shared[l].owner = (int)w->core_pos;
+
+	/* Give the other threads a chance to break in */
+	count = shared[l].count;
+	if ((rand_r(&w->seed) % 16) == 0) {
+		sched_yield();
+	}
+	shared[l].count = count + 1UL;
+
+	w->taken[l]++;
+}
+
+static void unlock(worker_t *w, unsigned int l)
+{
+	if (shared[l].owner != (int)w->core_pos) {
+		fprintf(stderr, "CPU %u: lock %u taken over by CPU %d\n",
+			w->core_pos, l, shared[l].owner);
+		w->errors++;
+	}
+	shared[l].owner = -1;
+
+	bakery_lock_release(get_lock(l));
+}
+
+static void *worker_main(void *arg)
+{
+	worker_t *w = arg;
+	unsigned int i;
+
+	my_core_pos = w->core_pos;
+
+	for (i = 0U; i < iterations; i++) {
+		if ((i % ROUND_ITERATIONS) == 0U) {
+			pthread_barrier_wait(&round_barrier);
+		}
+
+		if ((unsigned int)(rand_r(&w->seed) % 100) < uncached) {
+			test_sctlr_el3 = 0U;
+		} else {
+			test_sctlr_el3 = SCTLR_C_BIT;
+		}
+
+		switch (rand_r(&w->seed) % 4) {
+		case 0:
+			lock(w, 0U);
+			unlock(w, 0U);
+			break;
+		case 1:
+			lock(w, 1U);
+			unlock(w, 1U);
+			break;
+		case 2:
+			lock(w, 0U);
+			lock(w, 1U);
+			unlock(w, 1U);
+			unlock(w, 0U);
+			break;
+		default:
+			lock(w, 0U);
+			lock(w, 1U);
+			unlock(w, 0U);
+			unlock(w, 1U);
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	worker_t *workers;
+	unsigned long taken[NUM_LOCKS] = { 0UL };
+	unsigned long errors = 0UL;
+	struct timespec start, end;
+	double ns;
+	unsigned int i, l;
+
+	if (argc > 1) {
+		threads = (unsigned int)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		iterations = (unsigned int)strtoul(argv[2], NULL, 0);
+	}
+	if (argc > 3) {
+		uncached = (unsigned int)strtoul(argv[3], NULL, 0);
+	}
+
+	if ((threads == 0U) || (threads > PLATFORM_CORE_COUNT) ||
+	    (uncached > 100U)) {
+		fprintf(stderr, "threads must be 1 to %u, uncached 0 to 100\n",
+			(unsigned int)PLATFORM_CORE_COUNT);
+		return 2;
+	}
+
+	for (l = 0U; l < NUM_LOCKS; l++) {
+		shared[l].owner = -1;
+	}
+
+	workers = calloc(threads, sizeof(*workers));
+	if (workers == NULL) {
+		perror("calloc");
+		return 2;
+	}
+
+	pthread_barrier_init(&round_barrier, NULL, threads);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (i = 0U; i < threads; i++) {
+		workers[i].core_pos = i;
+		workers[i].seed = i + 1U;
+		if (pthread_create(&workers[i].thread, NULL, worker_main,
+				   &workers[i]) != 0) {
+			perror("pthread_create");
+			return 2;
+		}
+	}
+
+	for (i = 0U; i < threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+		errors += workers[i].errors;
+		for (l = 0U; l < NUM_LOCKS; l++) {
+			taken[l] += workers[i].taken[l];
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for (l = 0U; l < NUM_LOCKS; l++) {
+		if (shared[l].count != taken[l]) {
+			fprintf(stderr, "lock %u: count %lu, taken %lu times\n",
+				l, shared[l].count, taken[l]);
+			errors++;
+		}
+	}
+
+	ns = ((double)(end.tv_sec - start.tv_sec) * 1e9 +
+	      (double)(end.tv_nsec - start.tv_nsec)) /
+	     (double)(taken[0] + taken[1]);
+
+	printf("%s: %u threads, %u%% uncached, %lu locks taken, %.0f ns each, "
+	       "%lu errors\n", USE_QUEUED_BAKERY_LOCKS ? "queued" : "bakery",
+	       threads, uncached, taken[0] + taken[1], ns, errors);
+
+	pthread_barrier_destroy(&round_barrier);
+	free(workers);
+
+	return (errors == 0UL) ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <sched.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Host versions of what bakery_lock_normal.c uses. The host is coherent, so the
+ * cache maintenance operations do nothing, and waiting for an event yields so
+ * that the CPU being waited for gets to run.
+ */
+typedef uintptr_t u_register_t;
+
+#define SCTLR_C_BIT		(U(1) << 2)
+
+/* SCTLR_EL3 of the calling thread, to choose the cached or uncached path */
+extern __thread u_register_t test_sctlr_el3;
+
+static inline u_register_t read_sctlr_el3(void)
+{
+	return test_sctlr_el3;
+}
+
+static inline void dccvac(uintptr_t addr) { (void)addr; }
+static inline void dcivac(uintptr_t addr) { (void)addr; }
+static inline void dccivac(uintptr_t addr) { (void)addr; }
+
+static inline void dsbish(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void dmbld(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void dmbst(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+static inline void wfe(void) { sched_yield(); }
+static inline void sev(void) { }
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPU_DATA_H
+#define CPU_DATA_H
+
+/* bakery_lock_normal.c only needs CASSERT() from here */
+#include <lib/cassert.h>
+
+#endif /* CPU_DATA_H */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/* Index of the calling thread, see bakery_lock_test.c */
+unsigned int plat_my_core_pos(void);
+
+#endif /* PLATFORM_H */
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#include <lib/utils_def.h>
+
+#define PLATFORM_CORE_COUNT		U(8)
+#define CACHE_WRITEBACK_GRANULE		U(64)
+
+/* One cache line of locks per CPU, which the test lays out by hand */
+#define PLAT_PERCPU_BAKERY_LOCK_SIZE	CACHE_WRITEBACK_GRANULE
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Decode a dump of the EL3 trace region (ENABLE_EL3_TRACE=1) and print the
+ * latency of the SMCs handled by EL3, per function id, as histograms. The
+ * dump is the raw content of the region, read from PLAT_EL3_TRACE_BASE for
+ * example through /dev/mem or a debugger.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "el3_trace_ring.h"
+
+/* Latency buckets: below 1us, then one bucket per power of two of us */
+#define NUM_BUCKETS	16
+#define MAX_FIDS	128
+#define BAR_WIDTH	40
+
+typedef struct smc_stats {
+	uint32_t fid;
+	unsigned long count;
+	double min_us;
+	double max_us;
+	double total_us;
+	unsigned long buckets[NUM_BUCKETS];
+} smc_stats_t;
+
+static smc_stats_t smc_stats[MAX_FIDS];
+static unsigned int num_fids;
+static int verbose;
+
+static const char *event_name(uint32_t id)
+{
+	switch (id) {
+	case EL3_TRACE_SMC_ENTRY:
+		return "smc-entry";
+	case EL3_TRACE_SMC_EXIT:
+		return "smc-exit";
+	case EL3_TRACE_INTR_ENTRY:
+		return "intr-entry";
+	case EL3_TRACE_INTR_EXIT:
+		return "intr-exit";
+	case EL3_TRACE_PSCI_CPU_OFF:
+		return "psci-cpu-off";
+	case EL3_TRACE_PSCI_SUSPEND:
+		return "psci-suspend";
+	case EL3_TRACE_PSCI_WAKEUP:
+		return "psci-wakeup";
+	case EL3_TRACE_WORLD_SWITCH:
+		return "world-switch";
+	default:
+		return "unknown";
+	}
+}
+
+static smc_stats_t *get_stats(uint32_t fid)
+{
+	unsigned int i;
+
+	for (i = 0U; i < num_fids; i++) {
+		if (smc_stats[i].fid == fid)
+			return &smc_stats[i];
+	}
+
+	if (num_fids == MAX_FIDS)
+		return NULL;
+
+	memset(&smc_stats[num_fids], 0, sizeof(smc_stats[num_fids]));
+	smc_stats[num_fids].fid = fid;
+	return &smc_stats[num_fids++];
+}
+
+static void add_latency(uint32_t fid, double us)
+{
+	smc_stats_t *stats = get_stats(fid);
+	unsigned int bucket = 0U;
+
+	if (stats == NULL)
+		return;
+
+	while ((bucket < (NUM_BUCKETS - 1)) &&
+	       (us >= (double)(1UL << bucket)))
+		bucket++;
+
+	if ((stats->count == 0UL) || (us < stats->min_us))
+		stats->min_us = us;
+	if (us > stats->max_us)
+		stats->max_us = us;
+	stats->total_us += us;
+	stats->count++;
+	stats->buckets[bucket]++;
+}
+
+/*
+ * Go through the valid events of a ring in order. An SMC exit is matched
+ * with the last SMC entry of the CPU, as SMCs don't nest in EL3.
+ */
+static void decode_ring(unsigned int cpu, const el3_trace_ring_t *ring)
+{
+	const el3_trace_event_t *event;
+	uint64_t first, i, entry_ts = 0U;
+	uint32_t entry_fid = 0U;
+	int in_smc = 0;
+	double us;
+
+	first = (ring->head > ring->size) ? (ring->head - ring->size) : 0U;
+
+	if (verbose != 0) {
+		printf("CPU %u: %llu event(s), %llu lost\n", cpu,
+		       (unsigned long long)ring->head,
+		       (unsigned long long)first);
+	}
+
+	for (i = first; i < ring->head; i++) {
+		event = &ring->events[i & (ring->size - 1U)];
+		if (event->seq != (uint32_t)(i + 1U)) {
+			/* Being written when the region was dumped */
+			in_smc = 0;
+			continue;
+		}
+
+		if (verbose != 0) {
+			printf("  %16llu  %-13s 0x%08llx 0x%016llx\n",
+			       (unsigned long long)event->timestamp,
+			       event_name(event->id),
+			       (unsigned long long)event->arg0,
+			       (unsigned long long)event->arg1);
+		}
+
+		if (event->id == EL3_TRACE_SMC_ENTRY) {
+			entry_fid = (uint32_t)event->arg0;
+			entry_ts = event->timestamp;
+			in_smc = 1;
+		} else if ((event->id == EL3_TRACE_SMC_EXIT) && (in_smc != 0) &&
+			   ((uint32_t)event->arg0 == entry_fid)) {
+			us = (double)(event->timestamp - entry_ts) * 1e6 /
+			     (double)ring->freq;
+			add_latency(entry_fid, us);
+			in_smc = 0;
+		}
+	}
+}
+
+static void print_histograms(void)
+{
+	const smc_stats_t *stats;
+	unsigned long max_count;
+	unsigned int i, b, width;
+
+	for (i = 0U; i < num_fids; i++) {
+		stats = &smc_stats[i];
+
+		printf("SMC 0x%08x: %lu call(s), min %.2f us, avg %.2f us, "
+		       "max %.2f us\n", stats->fid, stats->count,
+		       stats->min_us, stats->total_us / (double)stats->count,
+		       stats->max_us);
+
+		max_count = 0UL;
+		for (b = 0U; b < NUM_BUCKETS; b++) {
+			if (stats->buckets[b] > max_count)
+				max_count = stats->buckets[b];
+		}
+
+		for (b = 0U; b < NUM_BUCKETS; b++) {
+			if (stats->buckets[b] == 0UL)
+				continue;
+
+			if (b == 0U)
+				printf("  %7s < %-6u us ", "", 1U);
+			else if (b == (NUM_BUCKETS - 1))
+				printf("  %7s >= %-5lu us ", "", 1UL << (b - 1U));
+			else
+				printf("  %7lu - %-6lu us ", 1UL << (b - 1U),
+				       1UL << b);
+
+			width = (unsigned int)((stats->buckets[b] * BAR_WIDTH +
+					       max_count - 1UL) / max_count);
+			printf("%8lu |%.*s\n", stats->buckets[b], (int)width,
+			       "########################################");
+		}
+	}
+}
+
+static void usage(void)
+{
+	printf("el3_trace_decode [-v] <dump file>\n\n");
+	printf("Print per-SMC latency histograms from a dump of the EL3 trace "
+	       "region.\n\n");
+	printf("  -v  Also print the events of each CPU\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const el3_trace_ring_t *ring;
+	unsigned char *buf;
+	size_t size, offset, stride;
+	unsigned int cpu;
+	long len;
+	FILE *fp;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "v")) != -1) {
+		switch (opt) {
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != (argc - 1))
+		usage();
+
+	fp = fopen(argv[optind], "rb");
+	if (fp == NULL) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		perror(argv[optind]);
+		fclose(fp);
+		return 1;
+	}
+
+	size = (size_t)len;
+	buf = malloc((size != 0U) ? size : 1U);
+	if (buf == NULL) {
+		fprintf(stderr, "error: malloc: %s\n", argv[optind]);
+		fclose(fp);
+		return 1;
+	}
+
+	if (fread(buf, 1U, size, fp) != size) {
+		fprintf(stderr, "error: failed to read %s\n", argv[optind]);
+		free(buf);
+		fclose(fp);
+		return 1;
+	}
+	fclose(fp);
+
+	/* The rings follow each other until the end of the region */
+	for (offset = 0U, cpu = 0U;
+	     (size - offset) >= EL3_TRACE_RING_HDR_SIZE; cpu++) {
+		ring = (const el3_trace_ring_t *)&buf[offset];
+		if (ring->magic != EL3_TRACE_RING_MAGIC)
+			break;
+
+		if ((ring->size == 0U) || ((ring->size & (ring->size - 1U)) != 0U)
+		    || (ring->freq == 0U)) {
+			fprintf(stderr, "error: invalid ring for CPU %u\n", cpu);
+			break;
+		}
+
+		stride = EL3_TRACE_RING_STRIDE((size_t)ring->size);
+		if ((size - offset) < stride) {
+			fprintf(stderr, "error: ring for CPU %u truncated\n",
+				cpu);
+			break;
+		}
+
+		decode_ring(cpu, ring);
+		offset += stride;
+	}
+
+	if (cpu == 0U) {
+		fprintf(stderr, "error: no EL3 trace ring in %s\n",
+			argv[optind]);
+		free(buf);
+		return 1;
+	}
+
+	print_histograms();
+
+	free(buf);
+	return 0;
+}
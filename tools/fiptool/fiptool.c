@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -51,6 +51,7 @@ static cmd_t cmds[] = {
 
 static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
+static file_map_t *file_map_head;
 static const uuid_t uuid_null;
 static int verbose;
 
@@ -134,6 +135,191 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+static void xfseek(FILE *fp, uint64_t offset)
+{
+	if (fseek(fp, offset, SEEK_SET))
+		log_errx("Failed to set file position");
+}
+
+static void write_zeroes(FILE *fp, uint64_t size, const char *filename)
+{
+	static char zeroes[4096];
+	size_t len;
+
+	while (size != 0) {
+		len = size < sizeof(zeroes) ? size : sizeof(zeroes);
+		xfwrite(zeroes, len, fp, filename);
+		size -= len;
+	}
+}
+
+static int same_file(const struct BLD_PLAT_STAT *a,
+    const struct BLD_PLAT_STAT *b)
+{
+#ifndef _MSC_VER
+	return a->st_dev == b->st_dev && a->st_ino == b->st_ino;
+#else
+	/* Windows does not report inode numbers. */
+	return 0;
+#endif
+}
+
+/*
+ * Map 'filename' into memory. Where mmap() is not available or fails, e.g.
+ * for an empty file, the file is read into memory instead. The file stays
+ * open so that images can be copied from it by the kernel.
+ */
+static file_map_t *map_file(const char *filename)
+{
+	file_map_t *map;
+	FILE *fp;
+
+	map = xzalloc(sizeof(*map), "failed to allocate memory for file map");
+	map->fd = -1;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &map->st) == -1)
+		log_err("fstat %s", filename);
+	map->size = map->st.st_size;
+
+#ifndef _MSC_VER
+	if (map->size != 0) {
+		map->addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (map->addr != MAP_FAILED)
+			map->mapped = 1;
+	}
+	map->fd = dup(fileno(fp));
+#endif
+	if (!map->mapped) {
+		map->addr = xmalloc(map->size, "failed to load file into memory");
+		if (fread(map->addr, 1, map->size, fp) != map->size)
+			log_errx("Failed to read %s", filename);
+	}
+	fclose(fp);
+
+	map->next = file_map_head;
+	file_map_head = map;
+	return map;
+}
+
+static void unmap_file(file_map_t *map)
+{
+	file_map_t **p = &file_map_head;
+
+	assert(map->refcount == 0);
+
+	while (*p != map)
+		p = &(*p)->next;
+	*p = map->next;
+
+#ifndef _MSC_VER
+	if (map->mapped)
+		munmap(map->addr, map->size);
+	if (map->fd != -1)
+		close(map->fd);
+#endif
+	if (!map->mapped)
+		free(map->addr);
+	free(map);
+}
+
+/* Return whether 'filename' is one of the files images are read from. */
+static int is_mapped_file(const char *filename,
+    struct BLD_PLAT_STAT *st)
+{
+#ifndef _MSC_VER
+	file_map_t *map;
+
+	if (stat(filename, st) == -1)
+		return 0;
+
+	for (map = file_map_head; map != NULL; map = map->next)
+		if (same_file(&map->st, st))
+			return 1;
+#endif
+	/* Visual Studio builds read the input files into memory. */
+	return 0;
+}
+
+static image_t *new_image(file_map_t *map, uint64_t offset, uint64_t size)
+{
+	image_t *image;
+
+	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
+	image->buffer = map->addr + offset;
+	image->toc_e.size = size;
+	image->map = map;
+	map->refcount++;
+	return image;
+}
+
+static void free_image(image_t *image)
+{
+	if (--image->map->refcount == 0)
+		unmap_file(image->map);
+	free(image);
+}
+
+#if defined(HAVE_COPY_FILE_RANGE) || defined(HAVE_SENDFILE)
+/*
+ * Copy up to 'len' bytes between two files without going through user space.
+ * Returns the number of bytes copied, which is less than 'len' when the
+ * kernel cannot copy between these files.
+ */
+static size_t copy_file_data(int out_fd, off_t out_off, int in_fd,
+    off_t in_off, size_t len)
+{
+	size_t done = 0;
+	ssize_t n;
+
+#ifdef HAVE_COPY_FILE_RANGE
+	while (done < len) {
+		n = copy_file_range(in_fd, &in_off, out_fd, &out_off,
+		    len - done, 0);
+		if (n <= 0)
+			break;
+		done += n;
+	}
+#endif
+#ifdef HAVE_SENDFILE
+	if (done < len && lseek(out_fd, out_off, SEEK_SET) == out_off) {
+		while (done < len) {
+			n = sendfile(out_fd, in_fd, &in_off, len - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+	}
+#endif
+	return done;
+}
+#endif
+
+/* Write the payload of 'image' at 'offset' in the output file 'fp'. */
+static void write_image(FILE *fp, uint64_t offset, const image_t *image,
+    const char *filename)
+{
+	size_t done = 0;
+
+#if defined(HAVE_COPY_FILE_RANGE) || defined(HAVE_SENDFILE)
+	if (image->map->fd != -1) {
+		if (fflush(fp) != 0)
+			log_err("fflush %s", filename);
+		done = copy_file_data(fileno(fp), offset, image->map->fd,
+		    (char *)image->buffer - image->map->addr,
+		    image->toc_e.size);
+	}
+#endif
+	/* Write what the kernel could not copy from the mapped image. */
+	xfseek(fp, offset + done);
+	xfwrite((char *)image->buffer + done, image->toc_e.size - done, fp,
+	    filename);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -169,10 +355,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -280,27 +464,18 @@ static void uuid_from_str(uuid_t *u, const char *s)
 
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
-	struct BLD_PLAT_STAT st;
-	FILE *fp;
+	file_map_t *map;
 	char *buf, *bufend;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	/* The images point into the mapping rather than being copied. */
+	map = map_file(filename);
+	buf = map->addr;
+	bufend = buf + map->size;
 
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
-
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
-	if (st.st_size < sizeof(fip_toc_header_t))
+	if (map->size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -324,23 +499,19 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 			break;
 		}
 
-		/*
-		 * Build a new image out of the ToC entry and add it to the
-		 * table of images.
-		 */
-		image = xzalloc(sizeof(*image),
-		    "failed to allocate memory for image");
-		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before pointing into the file. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+		if (toc_entry->size + toc_entry->offset_address > map->size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
+		/*
+		 * Build a new image out of the ToC entry and add it to the
+		 * table of images.
+		 */
+		image = new_image(map, toc_entry->offset_address,
 		    toc_entry->size);
+		image->toc_e = *toc_entry;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -366,34 +537,22 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+	if (map->refcount == 0)
+		unmap_file(map);
 	return 0;
 }
 
 static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
-	struct BLD_PLAT_STAT st;
+	file_map_t *map;
 	image_t *image;
-	FILE *fp;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
-	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
+	map = map_file(filename);
+	image = new_image(map, 0, map->size);
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
-
-	fclose(fp);
 	return image;
 }
 
@@ -404,8 +563,9 @@ static int write_image_to_file(const image_t *image, const char *filename)
 	fp = fopen(filename, "wb");
 	if (fp == NULL)
 		log_err("fopen");
-	xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	fclose(fp);
+	write_image(fp, 0, image, filename);
+	if (fclose(fp) != 0)
+		log_err("fclose %s", filename);
 	return 0;
 }
 
@@ -442,10 +602,81 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	image_t        **images;
+	unsigned char  (*md)[SHA256_DIGEST_LENGTH];
+	size_t           nr_images;
+	size_t           next;
+	pthread_mutex_t  lock;
+} hash_job_t;
+
+static void *hash_worker(void *arg)
+{
+	hash_job_t *job = arg;
+	size_t i;
+
+	while (1) {
+		pthread_mutex_lock(&job->lock);
+		i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (i >= job->nr_images)
+			break;
+		SHA256(job->images[i]->buffer, job->images[i]->toc_e.size,
+		    job->md[i]);
+	}
+	return NULL;
+}
+
+/*
+ * Compute the SHA-256 of each image into 'md', spreading the images over one
+ * thread per online CPU.
+ */
+static void hash_images(image_t **images,
+    unsigned char (*md)[SHA256_DIGEST_LENGTH], size_t nr_images)
+{
+	hash_job_t job = { images, md, nr_images, 0 };
+	pthread_t *threads;
+	size_t nr_threads = 0;
+	long nr_cpus;
+
+	nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nr_cpus < 1)
+		nr_cpus = 1;
+	if ((size_t)nr_cpus > nr_images)
+		nr_cpus = nr_images;
+
+	pthread_mutex_init(&job.lock, NULL);
+	threads = xmalloc(sizeof(*threads) * (nr_cpus + 1),
+	    "failed to allocate memory for threads");
+
+	/* This thread is one of the workers. */
+	while (nr_threads + 1 < (size_t)nr_cpus) {
+		if (pthread_create(&threads[nr_threads], NULL, hash_worker,
+		    &job) != 0)
+			break;
+		nr_threads++;
+	}
+	hash_worker(&job);
+
+	while (nr_threads != 0)
+		pthread_join(threads[--nr_threads], NULL);
+
+	free(threads);
+	pthread_mutex_destroy(&job.lock);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	image_t **images = NULL;
+	unsigned char (*md)[SHA256_DIGEST_LENGTH] = NULL;
+	size_t i = 0;
+#endif
 
 	if (argc != 2)
 		info_usage();
@@ -462,6 +693,22 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	/* Hash all the images up front, in parallel. */
+	if (verbose) {
+		size_t nr_images = 0;
+
+		images = xmalloc(sizeof(*images) * (nr_image_descs + 1),
+		    "failed to allocate memory for images");
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				images[nr_images++] = desc->image;
+		md = xmalloc(sizeof(*md) * (nr_images + 1),
+		    "failed to allocate memory for hashes");
+		hash_images(images, md, nr_images);
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -474,16 +721,17 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(md[i++], SHA256_DIGEST_LENGTH);
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(md);
+	free(images);
+#endif
 	return 0;
 }
 
@@ -493,14 +741,18 @@ static void info_usage(void)
 	exit(1);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+/*
+ * Lay out the images of the image table and build the header and ToC entries
+ * of the FIP. Returns the ToC and its size in 'buf_size_out'.
+ */
+static char *build_toc(uint64_t toc_flags, unsigned long align,
+    uint64_t *buf_size_out)
 {
-	FILE *fp;
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
+	uint64_t entry_offset, buf_size;
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
@@ -527,7 +779,6 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 		if (image == NULL)
 			continue;
-		payload_size += image->toc_e.size;
 		entry_offset = (entry_offset + align - 1) & ~(align - 1);
 		image->toc_e.offset_address = entry_offset;
 		*toc_entry++ = image->toc_e;
@@ -542,8 +793,61 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	memset(toc_entry, 0, sizeof(*toc_entry));
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
-	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
+	*buf_size_out = buf_size;
+	return buf;
+}
+
+static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+{
+	struct BLD_PLAT_STAT st;
+	FILE *fp = NULL;
+	image_desc_t *desc;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	char *buf, target[PATH_MAX];
+	char tmpname[PATH_MAX + sizeof(".XXXXXX")] = { 0 };
+	uint64_t entry_offset, buf_size, payload_size = 0;
+	size_t nr_images = 0;
+
+	buf = build_toc(toc_flags, align, &buf_size);
+	toc_header = (fip_toc_header_t *)buf;
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+
+	entry_offset = buf_size;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		payload_size += image->toc_e.size;
+		entry_offset = image->toc_e.offset_address + image->toc_e.size;
+		nr_images++;
+	}
+	toc_entry += nr_images;
+
+	/*
+	 * Generate the FIP file. The images are read from their files while
+	 * the FIP is written, so if the FIP is one of them, e.g. when updating
+	 * it, write a new file and rename it over the old one at the end.
+	 */
+	if (is_mapped_file(filename, &st)) {
+#ifndef _MSC_VER
+		int fd;
+
+		/* Replace the file a symbolic link points to, not the link. */
+		if (realpath(filename, target) == NULL)
+			log_err("realpath %s", filename);
+		snprintf(tmpname, sizeof(tmpname), "%s.XXXXXX", target);
+		fd = mkstemp(tmpname);
+		if (fd == -1)
+			log_err("mkstemp %s", tmpname);
+		if (fchmod(fd, st.st_mode & 07777) == -1)
+			log_err("fchmod %s", tmpname);
+		fp = fdopen(fd, "wb");
+#endif
+	} else {
+		fp = fopen(filename, "wb");
+	}
 	if (fp == NULL)
 		log_err("fopen %s", filename);
 
@@ -560,22 +864,97 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 		if (image == NULL)
 			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
+		write_image(fp, image->toc_e.offset_address, image, filename);
+	}
+
+	xfseek(fp, entry_offset);
+	write_zeroes(fp, toc_entry->offset_address - entry_offset, filename);
+
+	free(buf);
+	if (fclose(fp) != 0)
+		log_err("fclose %s", filename);
+	if (tmpname[0] != '\0' && rename(tmpname, target) == -1)
+		log_err("rename %s", filename);
+	return 0;
+}
 
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+/*
+ * Update the FIP 'filename' in place when only the images replaced by the
+ * update need to be written, i.e. when the new layout of the FIP matches the
+ * one on disk because every new image takes the place of the image it
+ * replaces. Returns 0 if the FIP was updated, or -1 if it must be packed
+ * again with pack_images().
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	struct BLD_PLAT_STAT st;
+	FILE *fp;
+	image_desc_t *desc;
+	fip_toc_entry_t *toc_entry, *old_entry;
+	char *buf, *old_buf;
+	uint64_t buf_size, fip_size, i, nr_entries;
+	int ret = -1;
+
+	buf = build_toc(toc_flags, align, &buf_size);
+	nr_entries = (buf_size - sizeof(fip_toc_header_t)) /
+	    sizeof(fip_toc_entry_t);
+	fip_size = ((fip_toc_entry_t *)(buf + buf_size))[-1].offset_address;
+
+	fp = fopen(filename, "r+b");
+	if (fp == NULL) {
+		free(buf);
+		return -1;
 	}
+	if (fstat(fileno(fp), &st) == -1)
+		log_err("fstat %s", filename);
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
+	/* Compare the new layout with the one on disk. */
+	old_buf = xmalloc(buf_size, "failed to allocate memory for ToC");
+	if (st.st_size != fip_size ||
+	    fread(old_buf, 1, buf_size, fp) != buf_size)
+		goto out;
+
+	toc_entry = (fip_toc_entry_t *)((fip_toc_header_t *)buf + 1);
+	old_entry = (fip_toc_entry_t *)((fip_toc_header_t *)old_buf + 1);
+	for (i = 0; i < nr_entries; i++, toc_entry++, old_entry++) {
+		if (memcmp(&toc_entry->uuid, &old_entry->uuid,
+		    sizeof(uuid_t)) != 0 ||
+		    toc_entry->offset_address != old_entry->offset_address)
+			goto out;
+	}
+
+	/* Write the images that are not already in place. */
+	old_entry = (fip_toc_entry_t *)((fip_toc_header_t *)old_buf + 1);
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
 
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+		if (image == NULL)
+			continue;
+		if (!same_file(&image->map->st, &st) ||
+		    (char *)image->buffer - image->map->addr !=
+		    image->toc_e.offset_address) {
+			if (verbose)
+				log_dbgx("Writing %s in place",
+				    desc->cmdline_name);
+			write_image(fp, image->toc_e.offset_address, image,
+			    filename);
+			if (old_entry->size > image->toc_e.size)
+				write_zeroes(fp, old_entry->size -
+				    image->toc_e.size, filename);
+		}
+		old_entry++;
+	}
 
+	xfseek(fp, 0);
+	xfwrite(buf, buf_size, fp, filename);
+	ret = 0;
+out:
+	free(old_buf);
 	free(buf);
-	fclose(fp);
-	return 0;
+	if (fclose(fp) != 0)
+		log_err("fclose %s", filename);
+	return ret;
 }
 
 /*
@@ -604,7 +983,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -847,6 +1226,10 @@ static int update_cmd(int argc, char *argv[])
 
 	update_fip();
 
+	if (strcmp(outfile, argv[0]) == 0 &&
+	    update_fip_in_place(outfile, toc_flags, align) == 0)
+		return 0;
+
 	pack_images(outfile, toc_flags, align);
 	return 0;
 }
@@ -1098,7 +1481,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
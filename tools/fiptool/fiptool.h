@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,9 @@
 #ifndef FIPTOOL_H
 #define FIPTOOL_H
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -40,9 +43,24 @@ typedef struct image_desc {
 	struct image_desc *next;
 } image_desc_t;
 
+/*
+ * An input file, mapped into memory where the host supports it and read into
+ * memory otherwise. The images of a FIP all point into the mapping of the FIP.
+ */
+typedef struct file_map {
+	char                 *addr;
+	size_t                size;
+	int                   mapped;
+	int                   fd;
+	struct BLD_PLAT_STAT  st;
+	unsigned int          refcount;
+	struct file_map      *next;
+} file_map_t;
+
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	struct file_map     *map;
 } image_t;
 
 typedef struct cmd {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -15,12 +15,25 @@
 #ifndef _MSC_VER
 
 /* Not Visual Studio, so include Posix Headers. */
+# include <sys/mman.h>
 # include <getopt.h>
 # include <openssl/sha.h>
+# include <pthread.h>
 # include <unistd.h>
 
 # define  BLD_PLAT_STAT stat
 
+/* Let the kernel copy images between files where it can. */
+# ifdef __linux__
+#  include <sys/sendfile.h>
+#  define HAVE_SENDFILE
+#  ifdef __GLIBC_PREREQ
+#   if __GLIBC_PREREQ(2, 27)
+#    define HAVE_COPY_FILE_RANGE
+#   endif
+#  endif
+# endif
+
 #else
 
 /* Visual Studio. */
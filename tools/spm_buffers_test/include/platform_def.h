@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#include <lib/utils_def.h>
+
+/* Same default as the Arm platforms, can be overridden from the command line */
+#ifndef PLAT_SPM_RESPONSES_MAX
+#define PLAT_SPM_RESPONSES_MAX		U(30)
+#endif
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host stress test of the SPM response table (spm_buffers.c).
+ *
+ * Each thread takes tokens from a shared sequential counter, as the SPM does,
+ * and keeps up to PLAT_SPM_RESPONSES_MAX / threads responses in the table, so
+ * that the table can be full but no add should fail. Responses are read back
+ * in random order, so that tokens of the same home slot are in the table at
+ * the same time and have to be probed for. The test checks that:
+ * - every add of a new token succeeds, and adding it again fails;
+ * - a get with the wrong client ID fails and leaves the response in place;
+ * - a get returns the values that were added, and only once;
+ * - the table is empty, with all its slots free, at the end.
+ *
+ * Usage: spm_buffers_test [threads [iterations]]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <lib/spinlock.h>
+
+/* spm_private.h needs the whole SPM, only the table is tested here */
+#define SPM_PRIVATE_H
+#include "../../services/std_svc/spm/spm_buffers.c"
+
+#define DEFAULT_THREADS		4U
+#define DEFAULT_ITERATIONS	1000000U
+
+typedef struct worker {
+	pthread_t thread;
+	uint16_t client_id;
+	unsigned int seed;
+	unsigned long adds;
+	unsigned long errors;
+} worker_t;
+
+static unsigned int threads = DEFAULT_THREADS;
+static unsigned int iterations = DEFAULT_ITERATIONS;
+static unsigned int depth;
+static uint32_t next_token;
+
+/* Host versions of the spinlock functions of lib/locks/exclusive */
+void spin_lock(spinlock_t *lock)
+{
+	while (spin_trylock(lock) == 0) {
+		;
+	}
+}
+
+int spin_trylock(spinlock_t *lock)
+{
+	return __atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) == 0U;
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+}
+
+static void check(worker_t *w, bool ok, const char *what, uint32_t token)
+{
+	if (!ok) {
+		fprintf(stderr, "client %u, token %u: %s\n",
+			(unsigned int)w->client_id, (unsigned int)token, what);
+		w->errors++;
+	}
+}
+
+static void add(worker_t *w, uint32_t token)
+{
+	int rc;
+
+	rc = spm_response_add(w->client_id, (uint16_t)token, token, token,
+			      ~(u_register_t)token, (u_register_t)token << 7);
+	check(w, rc == 0, "add failed", token);
+	w->adds++;
+
+	if ((token % 8U) == 0U) {
+		rc = spm_response_add(w->client_id, (uint16_t)token, token,
+				      0U, 0U, 0U);
+		check(w, rc != 0, "duplicate token added", token);
+	}
+}
+
+static void get(worker_t *w, uint32_t token)
+{
+	u_register_t x1 = 0U, x2 = 0U, x3 = 0U;
+	int rc;
+
+	rc = spm_response_get(w->client_id + 1U, (uint16_t)token, token,
+			      &x1, &x2, &x3);
+	check(w, rc != 0, "got with the wrong client ID", token);
+
+	rc = spm_response_get(w->client_id, (uint16_t)token, token,
+			      &x1, &x2, &x3);
+	check(w, rc == 0, "get failed", token);
+	check(w, (x1 == token) && (x2 == ~(u_register_t)token) &&
+		 (x3 == ((u_register_t)token << 7)), "wrong values", token);
+
+	rc = spm_response_get(w->client_id, (uint16_t)token, token,
+			      &x1, &x2, &x3);
+	check(w, rc != 0, "got twice", token);
+}
+
+static void *worker_main(void *arg)
+{
+	worker_t *w = arg;
+	uint32_t pending[PLAT_SPM_RESPONSES_MAX];
+	unsigned int i, k, n = 0U;
+
+	for (i = 0U; i < iterations; i++) {
+		if (n < depth) {
+			pending[n] = __atomic_fetch_add(&next_token, 1U,
+							__ATOMIC_RELAXED);
+			add(w, pending[n]);
+			n++;
+		}
+
+		if ((n == depth) || ((rand_r(&w->seed) & 1) != 0)) {
+			k = (unsigned int)rand_r(&w->seed) % n;
+			get(w, pending[k]);
+			n--;
+			pending[k] = pending[n];
+		}
+	}
+
+	while (n > 0U) {
+		n--;
+		get(w, pending[n]);
+	}
+
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	worker_t *workers;
+	unsigned long adds = 0UL, errors = 0UL;
+	unsigned int i;
+
+	if (argc > 1) {
+		threads = (unsigned int)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		iterations = (unsigned int)strtoul(argv[2], NULL, 0);
+	}
+
+	if ((threads == 0U) || (threads > PLAT_SPM_RESPONSES_MAX)) {
+		fprintf(stderr, "threads must be 1 to %u\n",
+			(unsigned int)PLAT_SPM_RESPONSES_MAX);
+		return 2;
+	}
+
+	depth = PLAT_SPM_RESPONSES_MAX / threads;
+
+	workers = calloc(threads, sizeof(*workers));
+	if (workers == NULL) {
+		perror("calloc");
+		return 2;
+	}
+
+	for (i = 0U; i < threads; i++) {
+		/* Even IDs, so that client_id + 1 is never a real client */
+		workers[i].client_id = (uint16_t)(i * 2U);
+		workers[i].seed = i + 1U;
+		if (pthread_create(&workers[i].thread, NULL, worker_main,
+				   &workers[i]) != 0) {
+			perror("pthread_create");
+			return 2;
+		}
+	}
+
+	for (i = 0U; i < threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+		adds += workers[i].adds;
+		errors += workers[i].errors;
+	}
+
+	for (i = 0U; i < PLAT_SPM_RESPONSES_MAX; i++) {
+		if ((responses[i].is_valid != 0) ||
+		    (responses[i].used.lock != 0U) ||
+		    (home_lock[i].lock != 0U)) {
+			fprintf(stderr, "slot %u not free at the end\n", i);
+			errors++;
+		}
+	}
+
+	printf("%u threads, %u slots, %lu responses, %lu errors\n", threads,
+	       (unsigned int)PLAT_SPM_RESPONSES_MAX, adds, errors);
+
+	free(workers);
+
+	return (errors == 0UL) ? 0 : 1;
+}